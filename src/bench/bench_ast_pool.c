@@ -0,0 +1,122 @@
+// AST representation benchmark: builds one large function as a pointer tree
+// (heap and arena) and as a compact AstPool, and reports the memory each
+// takes and the time of a full pre-order walk over it.
+//
+// usage: bench_ast_pool [statements]
+
+#include "bench_util.h"
+#include "../lexer/lexer.h"
+#include "../lexer/token_buffer.h"
+#include "../parser/parser.h"
+#include "../parser/ast_pool.h"
+
+// Visits every node the way the semantic analyzer does and folds in a
+// little of each node's data, so the walk cannot be optimized away
+static size_t walk_tree(const ASTNode* node) {
+    if (!node) return 0;
+    size_t sum = (size_t)node->type + node->loc.offset;
+    switch (node->type) {
+        case AST_NUMBER: sum += (size_t)node->value; break;
+        case AST_IDENTIFIER: sum += node->identifier; break;
+        case AST_BINARY_OP: sum += walk_tree(node->binop.left) + walk_tree(node->binop.right); break;
+        case AST_DECLARATION: sum += node->declaration.name + walk_tree(node->declaration.init); break;
+        case AST_ASSIGNMENT: sum += node->assignment.name + walk_tree(node->assignment.value); break;
+        case AST_BLOCK:
+        case AST_COMPOUND:
+        case AST_PROGRAM:
+            for (size_t i = 0; i < node->block.count; ++i) sum += walk_tree(node->block.statements[i]);
+            break;
+        case AST_IF:
+            sum += walk_tree(node->if_stmt.condition) + walk_tree(node->if_stmt.then_branch) +
+                   walk_tree(node->if_stmt.else_branch);
+            break;
+        case AST_WHILE: sum += walk_tree(node->while_stmt.condition) + walk_tree(node->while_stmt.body); break;
+        case AST_RETURN: sum += walk_tree(node->return_stmt.expr); break;
+        case AST_FUNCTION: sum += node->function.name + walk_tree(node->function.body); break;
+    }
+    return sum;
+}
+
+static size_t walk_pool(const AstPool* pool, AstRef ref) {
+    if (!ref) return 0;
+    ASTNodeType kind = ast_pool_kind(pool, ref);
+    size_t sum = (size_t)kind + ast_pool_offset(pool, ref);
+    switch (kind) {
+        case AST_NUMBER: sum += (size_t)(int)ast_pool_field(pool, ref, 0); break;
+        case AST_IDENTIFIER: sum += ast_pool_field(pool, ref, 0); break;
+        case AST_BINARY_OP:
+        case AST_WHILE:
+            sum += walk_pool(pool, ast_pool_field(pool, ref, 0)) + walk_pool(pool, ast_pool_field(pool, ref, 1));
+            break;
+        case AST_DECLARATION:
+        case AST_ASSIGNMENT:
+        case AST_FUNCTION:
+            sum += ast_pool_field(pool, ref, 0) + walk_pool(pool, ast_pool_field(pool, ref, 1));
+            break;
+        case AST_BLOCK:
+        case AST_COMPOUND:
+        case AST_PROGRAM:
+            for (size_t i = 0; i < ast_pool_field(pool, ref, 0); ++i) sum += walk_pool(pool, ast_pool_statement(pool, ref, i));
+            break;
+        case AST_IF:
+            sum += walk_pool(pool, ast_pool_field(pool, ref, 0)) + walk_pool(pool, ast_pool_field(pool, ref, 1)) +
+                   walk_pool(pool, ast_pool_field(pool, ref, 2));
+            break;
+        case AST_RETURN: sum += walk_pool(pool, ast_pool_field(pool, ref, 0)); break;
+    }
+    return sum;
+}
+
+static ASTNode* parse_tokens(const TokenBuffer* tokens, Arena* arena) {
+    Parser* parser = create_parser_from_tokens(tokens);
+    parser->arena = arena;
+    ASTNode* root = parse_program(parser);
+    free_parser(parser);
+    if (!root) {
+        fprintf(stdout, "parse failed\n");
+        exit(1);
+    }
+    return root;
+}
+
+int main(int argc, char* argv[]) {
+    size_t statements = argc > 1 ? (size_t)atoll(argv[1]) : 20000;
+    size_t length = 0;
+    char* source = bench_generate_source(1, statements, &length);  // a single function
+    Lexer* lexer = create_lexer(source);
+    TokenBuffer* tokens = lexer_tokenize(lexer);
+
+    ASTNode* heap_root = parse_tokens(tokens, NULL);
+    Arena* arena = create_arena(0);
+    ASTNode* arena_root = parse_tokens(tokens, arena);
+    double start = bench_now();
+    AstPool* pool = ast_pool_build(arena_root);
+    double build = bench_now() - start;
+
+    printf("input: %.1f MB, %zu tokens, %zu nodes\n", (double)length / (1 << 20), tokens->count, pool->nodes);
+    printf("arena tree %8.1f MB\n", (double)arena->bytes / (1 << 20));
+    printf("pool       %8.1f MB  (built in %.2f ms)\n", (double)(pool->count * sizeof(uint32_t)) / (1 << 20),
+           build * 1e3);
+
+    const char* names[] = { "heap tree", "arena tree", "pool" };
+    size_t check[3];
+    for (int kind = 0; kind < 3; ++kind) {
+        double best = 1e30;
+        for (int rep = 0; rep < 5; ++rep) {
+            start = bench_now();
+            check[kind] = kind == 0 ? walk_tree(heap_root) : kind == 1 ? walk_tree(arena_root) : walk_pool(pool, pool->root);
+            double elapsed = bench_now() - start;
+            if (elapsed < best) best = elapsed;
+        }
+        printf("walk %-10s %8.2f ms\n", names[kind], best * 1e3);
+    }
+    if (check[0] != check[2] || check[1] != check[2]) printf("walk results differ\n");
+
+    free_ast_pool(pool);
+    free_arena(arena);
+    free_ast(heap_root);
+    free_token_buffer(tokens);
+    free_lexer(lexer);
+    free(source);
+    return 0;
+}
@@ -0,0 +1,83 @@
+// Per-function compilation benchmark: parses a file of many generated
+// functions once, then times semantic analysis and code generation of the
+// whole program on 1..N threads. Code generation is timed through the IR
+// (the default) and straight from the AST (--ast-codegen), with the size of
+// the assembly each produces.
+//
+// usage: bench_compile [functions] [max_threads] 2>/dev/null
+
+#include "bench_util.h"
+#include "../lexer/lexer.h"
+#include "../lexer/token_buffer.h"
+#include "../parser/parser.h"
+#include "../parser/ast_pool.h"
+#include "../semantic/semantic_analyzer.h"
+#include "../codegen/asm_generator.h"
+#include "../utils/parallel.h"
+
+int main(int argc, char* argv[]) {
+    size_t functions = argc > 1 ? (size_t)atoll(argv[1]) : 4000;
+    int max_threads = argc > 2 ? atoi(argv[2]) : parallel_cpu_count();
+    if (max_threads < 1) max_threads = 1;
+
+    // Roughly 1.1 KB per function at 8 statements each
+    size_t length = 0;
+    char* source = bench_generate_source(functions * 1170, 8, &length);
+    Lexer* lexer = create_lexer(source);
+    TokenBuffer* tokens = lexer_tokenize(lexer);
+    Parser* parser = create_parser_from_tokens(tokens);
+    Arena* arena = create_arena(0);
+    parser->arena = arena;
+    ASTNode* root = parse_program(parser);
+    AstPool* pool = root ? ast_pool_build(root) : NULL;
+    if (!pool) {
+        fprintf(stdout, "parse failed\n");
+        return 1;
+    }
+    printf("input: %.1f MB, %zu functions\n", (double)length / (1 << 20), (size_t)ast_pool_field(pool, pool->root, 0));
+
+    FILE* sink = tmpfile();
+    if (!sink) {
+        fprintf(stdout, "cannot open a temporary file\n");
+        return 1;
+    }
+    double base = 0;
+    for (int threads = 1; threads <= max_threads; ++threads) {
+        double sema = 1e30, codegen = 1e30, ast_codegen = 1e30;
+        long ir_bytes = 0, ast_bytes = 0;
+        for (int rep = 0; rep < 3; ++rep) {
+            double start = bench_now();
+            analyze_semantics_pool(pool, threads);
+            double mid = bench_now();
+            rewind(sink);
+            generate_program_pool(sink, pool, threads, CODEGEN_IR);
+            fflush(sink);
+            ir_bytes = ftell(sink);
+            double end = bench_now();
+            rewind(sink);
+            generate_program_pool(sink, pool, threads, CODEGEN_AST);
+            fflush(sink);
+            ast_bytes = ftell(sink);
+            double ast_end = bench_now();
+            if (mid - start < sema) sema = mid - start;
+            if (end - mid < codegen) codegen = end - mid;
+            if (ast_end - end < ast_codegen) ast_codegen = ast_end - end;
+        }
+        if (threads == 1) base = sema + codegen;
+        printf("%2d threads  sema %8.2f ms  codegen %8.2f ms  speedup %.2fx  (AST codegen %8.2f ms)\n", threads,
+               sema * 1e3, codegen * 1e3, base / (sema + codegen), ast_codegen * 1e3);
+        if (threads == max_threads) {
+            printf("assembly: %.1f MB through the IR, %.1f MB from the AST\n", (double)ir_bytes / (1 << 20),
+                   (double)ast_bytes / (1 << 20));
+        }
+    }
+
+    fclose(sink);
+    free_ast_pool(pool);
+    free_arena(arena);
+    free_parser(parser);
+    free_token_buffer(tokens);
+    free_lexer(lexer);
+    free(source);
+    return 0;
+}
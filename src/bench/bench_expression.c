@@ -0,0 +1,73 @@
+// Expression parsing benchmark: parses single very long expressions (a flat
+// sum, a mix of all precedence levels, deeply nested parentheses) and reports
+// parse time per term.
+//
+// usage: bench_expression [terms]
+
+#include "bench_util.h"
+#include "../lexer/lexer.h"
+#include "../lexer/token_buffer.h"
+#include "../parser/parser.h"
+
+// int main() { int x = 1; int y = <expression>; return y; }
+static char* generate_expression(const char* shape, size_t terms) {
+    static const char* mixed_ops[] = { " + ", " * ", " - ", " / ", " < ", " + ", " * ", " == " };
+    BenchBuffer buf = {0};
+    char term[64];
+    bench_append(&buf, "int main() {\n    int x = 1;\n    int y = ");
+    if (strcmp(shape, "nested") == 0) {
+        for (size_t i = 0; i < terms; ++i) bench_append(&buf, "(");
+        bench_append(&buf, "x");
+        for (size_t i = 0; i < terms; ++i) {
+            snprintf(term, sizeof(term), " + %zu)", i);
+            bench_append(&buf, term);
+        }
+    } else {
+        bench_append(&buf, "x");
+        for (size_t i = 1; i < terms; ++i) {
+            const char* op = strcmp(shape, "sum") == 0 ? " + " : mixed_ops[i % 8];
+            snprintf(term, sizeof(term), "%s%s", op, (i & 1) ? "x" : "7");
+            bench_append(&buf, term);
+        }
+    }
+    bench_append(&buf, ";\n    return y;\n}\n");
+    return buf.data;
+}
+
+static double parse_best(const TokenBuffer* tokens) {
+    double best = 1e30;
+    for (int rep = 0; rep < 5; ++rep) {
+        Parser* parser = create_parser_from_tokens(tokens);
+        Arena* arena = create_arena(0);
+        parser->arena = arena;
+        double start = bench_now();
+        ASTNode* root = parse_program(parser);
+        double elapsed = bench_now() - start;
+        if (!root) {
+            fprintf(stdout, "parse failed\n");
+            exit(1);
+        }
+        if (elapsed < best) best = elapsed;
+        free_arena(arena);
+        free_parser(parser);
+    }
+    return best;
+}
+
+int main(int argc, char* argv[]) {
+    size_t terms = argc > 1 ? (size_t)atoll(argv[1]) : 100000;
+    const char* shapes[] = { "sum", "mixed", "nested" };
+    for (size_t s = 0; s < sizeof(shapes) / sizeof(shapes[0]); ++s) {
+        // Parentheses recurse once per level; keep nesting within a default stack
+        size_t n = strcmp(shapes[s], "nested") == 0 && terms > 10000 ? 10000 : terms;
+        char* source = generate_expression(shapes[s], n);
+        Lexer* lexer = create_lexer(source);
+        TokenBuffer* tokens = lexer_tokenize(lexer);
+        double best = parse_best(tokens);
+        printf("%-7s %8zu terms  %8.2f ms  %6.1f ns/term\n", shapes[s], n, best * 1e3, best * 1e9 / (double)n);
+        free_token_buffer(tokens);
+        free_lexer(lexer);
+        free(source);
+    }
+    return 0;
+}
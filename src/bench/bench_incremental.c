@@ -0,0 +1,90 @@
+// Incremental recompilation benchmark: compiles generated files of growing
+// size once, then times recompiling them after edits of growing size to a
+// definition in the middle of the file, against a full compile.
+//
+// usage: bench_incremental [max_mb] 2>/dev/null
+
+#include "bench_util.h"
+#include "../incremental/incremental.h"
+
+#define EDIT_REPS 5
+
+typedef struct {
+    const char* name;
+    size_t statements;  // 0: change one byte
+} EditShape;
+
+static char* statements_text(size_t count, size_t* out_len) {
+    BenchBuffer buf = {0};
+    for (size_t i = 0; i < count; ++i) bench_append(&buf, "    accumulator_value = accumulator_value + 1;\n");
+    *out_len = buf.length;
+    return buf.data;
+}
+
+int main(int argc, char* argv[]) {
+    size_t max_mb = argc > 1 ? (size_t)atoll(argv[1]) : 16;
+    const EditShape shapes[] = {
+        { "1 byte", 0 }, { "1 stmt", 1 }, { "10 stmts", 10 }, { "100 stmts", 100 }, { "1000 stmts", 1000 },
+    };
+
+    for (size_t mb = 1; mb <= max_mb; mb *= 4) {
+        size_t length = 0;
+        char* source = bench_generate_source(mb << 20, 8, &length);
+        double start = bench_now();
+        IncrementalSession* session = incremental_open(source, length);
+        double full = bench_now() - start;
+        if (!session) {
+            fprintf(stdout, "out of memory\n");
+            return 1;
+        }
+        printf("\n%zu MB, %zu definitions: full compile %.2f ms\n", mb, session->count, full * 1e3);
+        printf("%-10s %8s %12s %12s %10s\n", "edit", "bytes", "edit ms", "update ms", "re-lexed");
+
+        // Edits go right after the first line of the body of the middle definition
+        char header[64];
+        snprintf(header, sizeof(header), "int func_%zu() {\n", session->count / 2);
+        const char* at = strstr(source, header);
+        size_t offset = (size_t)(strchr(at + strlen(header), '\n') + 1 - source);
+
+        for (size_t s = 0; s < sizeof(shapes) / sizeof(shapes[0]); ++s) {
+            size_t inserted = 0, removed = 0;
+            char* text = shapes[s].statements ? statements_text(shapes[s].statements, &inserted) : NULL;
+            if (!text) {
+                // "int accumulator_value = 0;" becomes "= 1;"
+                text = malloc(1);
+                text[0] = '1';
+                inserted = removed = 1;
+                offset -= 3;
+            }
+            char* edited = malloc(length - removed + inserted);
+            memcpy(edited, source, offset);
+            memcpy(edited + offset, text, inserted);
+            memcpy(edited + offset + inserted, source + offset + removed, length - offset - removed);
+
+            double best_edit = 1e30, best_update = 1e30;
+            for (int rep = 0; rep < EDIT_REPS; ++rep) {
+                start = bench_now();
+                incremental_edit(session, offset, removed, text, inserted);
+                double elapsed = bench_now() - start;
+                if (elapsed < best_edit) best_edit = elapsed;
+                incremental_edit(session, offset, inserted, source + offset, removed);
+
+                start = bench_now();
+                incremental_update(session, edited, length - removed + inserted);
+                elapsed = bench_now() - start;
+                if (elapsed < best_update) best_update = elapsed;
+                incremental_update(session, source, length);
+            }
+            incremental_edit(session, offset, removed, text, inserted);
+            printf("%-10s %8zu %12.3f %12.3f %10zu\n", shapes[s].name, inserted, best_edit * 1e3, best_update * 1e3,
+                   session->relexed_bytes);
+            incremental_edit(session, offset, inserted, source + offset, removed);
+            if (removed) offset += 3;
+            free(edited);
+            free(text);
+        }
+        free_incremental_session(session);
+        free(source);
+    }
+    return 0;
+}
@@ -0,0 +1,83 @@
+// IR generation benchmark: builds IR for single functions of 100k to 1M+
+// statements (assignments, ifs, whiles and blocks mixed), so the cost per
+// instruction appended dominates. Time per statement should stay flat as the
+// function grows.
+//
+// usage: bench_ir [max_statements] 2>/dev/null
+
+#include "bench_util.h"
+#include "../lexer/lexer.h"
+#include "../lexer/token_buffer.h"
+#include "../parser/parser.h"
+#include "../parser/ast_pool.h"
+#include "../semantic/semantic_analyzer.h"
+#include "../ir/ir_generator.h"
+
+// int main() { int a = 0; int b = 1; <statements> return a; }
+static char* generate_function(size_t statements) {
+    BenchBuffer buf = {0};
+    char line[160];
+    bench_append(&buf, "int main() {\n    int a = 0;\n    int b = 1;\n");
+    for (size_t i = 0; i < statements; ++i) {
+        switch (i % 4) {
+            case 0: snprintf(line, sizeof(line), "    a = a + %zu * b;\n", i); break;
+            case 1: snprintf(line, sizeof(line), "    if (a > %zu) { b = a - 1; } else { b = b + 1; }\n", i); break;
+            case 2: snprintf(line, sizeof(line), "    while (b < a) { b = b * 2; }\n"); break;
+            default: snprintf(line, sizeof(line), "    { int t = a / 3; a = t - b; }\n"); break;
+        }
+        bench_append(&buf, line);
+    }
+    bench_append(&buf, "    return a;\n}\n");
+    return buf.data;
+}
+
+int main(int argc, char* argv[]) {
+    size_t max_statements = argc > 1 ? (size_t)atoll(argv[1]) : 1000000;
+    printf("%10s %12s %10s %12s %12s %10s\n", "statements", "instructions", "IR ms", "ns/stmt", "ns/instr",
+           "IR MB");
+    // 100k, 300k, 1M, 3M, ...
+    for (size_t statements = 100000; statements <= max_statements;
+         statements = statements % 3 == 0 ? statements / 3 * 10 : statements * 3) {
+        char* source = generate_function(statements);
+        Lexer* lexer = create_lexer(source);
+        TokenBuffer* tokens = lexer_tokenize(lexer);
+        Parser* parser = create_parser_from_tokens(tokens);
+        Arena* arena = create_arena(0);
+        parser->arena = arena;
+        ASTNode* root = parse_program(parser);
+        AstPool* pool = root ? ast_pool_build(root) : NULL;
+        if (!pool) {
+            fprintf(stdout, "parse failed\n");
+            return 1;
+        }
+        // Bind the variables to slots; the tree is no longer needed after that
+        free_arena(arena);
+        free_parser(parser);
+        free_token_buffer(tokens);
+        free_lexer(lexer);
+        free(source);
+        SemanticResult result;
+        AstRef function = ast_pool_statement(pool, pool->root, 0);
+        analyze_function_pool(pool, function, &result);
+        if (result.errors) {
+            fprintf(stdout, "semantic error: %s\n", result.first_message);
+            return 1;
+        }
+
+        IRProgram program = {0};
+        double start = bench_now();
+        int ok = generate_ir_program(pool, ast_pool_field(pool, function, 1), &program);
+        double elapsed = bench_now() - start;
+        if (!ok) {
+            fprintf(stdout, "out of memory\n");
+            return 1;
+        }
+        printf("%10zu %12zu %10.2f %12.1f %12.2f %10.1f\n", statements, program.count, elapsed * 1e3,
+               elapsed * 1e9 / (double)statements, elapsed * 1e9 / (double)program.count,
+               (double)(program.count * sizeof(IRInstruction)) / (1 << 20));
+
+        free_ir_program(&program);
+        free_ast_pool(pool);
+    }
+    return 0;
+}
@@ -0,0 +1,83 @@
+// Lexer throughput benchmark: tokenizes a large source with every run-scanning
+// kernel the CPU supports and reports MB/s. The scalar kernel is the
+// byte-at-a-time baseline. The last line times batch tokenization into a
+// TokenBuffer with the best kernel.
+//
+// usage: bench_lexer [source_file] [megabytes]
+
+#include "bench_util.h"
+#include "../lexer/lexer.h"
+#include "../lexer/lexer_scan.h"
+#include "../lexer/token_buffer.h"
+
+static double lex_all(const char* source, size_t* token_count) {
+    Lexer* lexer = create_lexer(source);
+    size_t count = 0;
+    double start = bench_now();
+    for (;;) {
+        Token* token = get_next_token(lexer);
+        TokenType type = token->type;
+        free_token(token);
+        ++count;
+        if (type == TOKEN_EOF) break;
+    }
+    double elapsed = bench_now() - start;
+    free_lexer(lexer);
+    *token_count = count;
+    return elapsed;
+}
+
+static double lex_batch(const char* source, size_t* token_count) {
+    Lexer* lexer = create_lexer(source);
+    double start = bench_now();
+    TokenBuffer* tokens = lexer_tokenize(lexer);
+    double elapsed = bench_now() - start;
+    *token_count = tokens ? tokens->count : 0;
+    free_token_buffer(tokens);
+    free_lexer(lexer);
+    return elapsed;
+}
+
+int main(int argc, char* argv[]) {
+    size_t megabytes = argc > 2 ? (size_t)atoi(argv[2]) : 64;
+    size_t length = 0;
+    char* source = NULL;
+    if (argc > 1 && strcmp(argv[1], "-") != 0) {
+        Lexer* file_lexer = create_lexer_from_file(argv[1]);
+        length = file_lexer->length;
+        source = malloc(length + 1);
+        memcpy(source, file_lexer->input, length);
+        source[length] = '\0';
+        free_lexer(file_lexer);
+    } else {
+        source = bench_generate_source(megabytes << 20, 64, &length);
+    }
+    printf("input: %.1f MB\n", (double)length / (1 << 20));
+
+    LexerScanKind kinds[] = { LEXER_SCAN_SCALAR, LEXER_SCAN_SSE2, LEXER_SCAN_AVX2 };
+    for (size_t k = 0; k < sizeof(kinds) / sizeof(kinds[0]); ++k) {
+        if (!lexer_scan_select(kinds[k])) {
+            printf("%-8s unsupported\n", lexer_scan_name(kinds[k]));
+            continue;
+        }
+        double best = 1e30;
+        size_t tokens = 0;
+        for (int rep = 0; rep < 3; ++rep) {
+            double t = lex_all(source, &tokens);
+            if (t < best) best = t;
+        }
+        printf("%-8s %8.1f MB/s  %zu tokens\n", lexer_scan_name(kinds[k]),
+               (double)length / (1 << 20) / best, tokens);
+    }
+
+    double best = 1e30;
+    size_t tokens = 0;
+    for (int rep = 0; rep < 3; ++rep) {
+        double t = lex_batch(source, &tokens);
+        if (t < best) best = t;
+    }
+    printf("%-8s %8.1f MB/s  %zu tokens (%s)\n", "batch",
+           (double)length / (1 << 20) / best, tokens, lexer_scan_name(lexer_scan_active()));
+    free(source);
+    return 0;
+}
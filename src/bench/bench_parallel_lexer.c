@@ -0,0 +1,74 @@
+// Parallel lexing scaling benchmark: batch-tokenizes a large source with 1..N
+// threads and reports MB/s and the speedup over one thread. Every run is
+// checked against the single-threaded token buffer.
+//
+// usage: bench_parallel_lexer [source_file|-] [megabytes] [max_threads]
+
+#include "bench_util.h"
+#include "../lexer/lexer.h"
+#include "../lexer/token_buffer.h"
+
+static double lex_parallel(const char* source, size_t length, int threads, TokenBuffer** out) {
+    Lexer lexer;
+    lexer_init_span(&lexer, source, length);
+    double start = bench_now();
+    TokenBuffer* tokens = lexer_tokenize_parallel(&lexer, threads, 0);
+    double elapsed = bench_now() - start;
+    *out = tokens;
+    return elapsed;
+}
+
+static int same_tokens(const TokenBuffer* a, const TokenBuffer* b) {
+    return a && b && a->count == b->count &&
+           memcmp(a->types, b->types, a->count) == 0 &&
+           memcmp(a->offsets, b->offsets, a->count * sizeof(uint32_t)) == 0 &&
+           memcmp(a->lengths, b->lengths, a->count * sizeof(uint32_t)) == 0 &&
+           memcmp(a->payloads, b->payloads, a->count * sizeof(uint32_t)) == 0;
+}
+
+int main(int argc, char* argv[]) {
+    size_t megabytes = argc > 2 ? (size_t)atoi(argv[2]) : 64;
+    int max_threads = argc > 3 ? atoi(argv[3]) : lexer_cpu_count();
+    size_t length = 0;
+    char* source = NULL;
+    Lexer* file_lexer = NULL;
+    if (argc > 1 && strcmp(argv[1], "-") != 0) {
+        file_lexer = create_lexer_from_file(argv[1]);
+        source = (char*)file_lexer->input;
+        length = file_lexer->length;
+    } else {
+        source = bench_generate_source(megabytes << 20, 64, &length);
+    }
+    printf("input: %.1f MB, %d CPUs\n", (double)length / (1 << 20), lexer_cpu_count());
+
+    TokenBuffer* reference = NULL;
+    double single = 0;
+    for (int threads = 1; threads <= max_threads; ++threads) {
+        double best = 1e30;
+        for (int rep = 0; rep < 3; ++rep) {
+            TokenBuffer* tokens = NULL;
+            double t = lex_parallel(source, length, threads, &tokens);
+            if (t < best) best = t;
+            if (!reference) {
+                reference = tokens;
+            } else {
+                if (!same_tokens(reference, tokens)) {
+                    fprintf(stderr, "token stream mismatch with %d threads\n", threads);
+                    return 1;
+                }
+                free_token_buffer(tokens);
+            }
+        }
+        if (threads == 1) single = best;
+        printf("%2d threads %8.1f MB/s  x%.2f  %zu tokens\n", threads,
+               (double)length / (1 << 20) / best, single / best, reference->count);
+    }
+
+    free_token_buffer(reference);
+    if (file_lexer) {
+        free_lexer(file_lexer);
+    } else {
+        free(source);
+    }
+    return 0;
+}
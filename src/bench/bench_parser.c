@@ -0,0 +1,99 @@
+// AST allocation benchmark: parses one large function with heap-allocated
+// nodes and again with an arena, and reports parse time, teardown time and
+// the number of allocations each path makes.
+//
+// usage: bench_parser [statements]
+
+#include "bench_util.h"
+#include "../lexer/lexer.h"
+#include "../lexer/token_buffer.h"
+#include "../parser/parser.h"
+
+// One malloc per node plus one per block statement array on the heap path
+static size_t count_allocations(const ASTNode* node) {
+    if (!node) return 0;
+    size_t n = 1;
+    switch (node->type) {
+        case AST_BLOCK:
+        case AST_COMPOUND:
+        case AST_PROGRAM:
+            n++;
+            for (size_t i = 0; i < node->block.count; ++i) n += count_allocations(node->block.statements[i]);
+            break;
+        case AST_BINARY_OP:
+            n += count_allocations(node->binop.left) + count_allocations(node->binop.right);
+            break;
+        case AST_DECLARATION: n += count_allocations(node->declaration.init); break;
+        case AST_ASSIGNMENT: n += count_allocations(node->assignment.value); break;
+        case AST_IF:
+            n += count_allocations(node->if_stmt.condition) + count_allocations(node->if_stmt.then_branch) +
+                 count_allocations(node->if_stmt.else_branch);
+            break;
+        case AST_WHILE:
+            n += count_allocations(node->while_stmt.condition) + count_allocations(node->while_stmt.body);
+            break;
+        case AST_RETURN: n += count_allocations(node->return_stmt.expr); break;
+        case AST_FUNCTION: n += count_allocations(node->function.body); break;
+        default: break;
+    }
+    return n;
+}
+
+typedef struct {
+    double parse;
+    double teardown;
+    size_t allocations;
+} ParseRun;
+
+static ParseRun parse_once(const TokenBuffer* tokens, int use_arena) {
+    ParseRun run = {0};
+    Parser* parser = create_parser_from_tokens(tokens);
+    Arena* arena = use_arena ? create_arena(0) : NULL;
+    parser->arena = arena;
+
+    double start = bench_now();
+    ASTNode* root = parse_program(parser);
+    run.parse = bench_now() - start;
+    if (!root) {
+        fprintf(stdout, "parse failed\n");
+        exit(1);
+    }
+
+    run.allocations = use_arena ? arena->chunk_count : count_allocations(root);
+    start = bench_now();
+    if (use_arena) {
+        free_arena(arena);
+    } else {
+        free_ast(root);
+    }
+    run.teardown = bench_now() - start;
+    free_parser(parser);
+    return run;
+}
+
+int main(int argc, char* argv[]) {
+    size_t statements = argc > 1 ? (size_t)atoll(argv[1]) : 20000;
+    size_t length = 0;
+    char* source = bench_generate_source(1, statements, &length);  // a single function
+    Lexer* lexer = create_lexer(source);
+    TokenBuffer* tokens = lexer_tokenize(lexer);
+    printf("input: %.1f MB, %zu tokens\n", (double)length / (1 << 20), tokens->count);
+
+    const char* names[] = { "heap", "arena" };
+    for (int use_arena = 0; use_arena < 2; ++use_arena) {
+        ParseRun best = { 1e30, 1e30, 0 };
+        for (int rep = 0; rep < 3; ++rep) {
+            ParseRun run = parse_once(tokens, use_arena);
+            if (run.parse < best.parse) best.parse = run.parse;
+            if (run.teardown < best.teardown) best.teardown = run.teardown;
+            best.allocations = run.allocations;
+        }
+        printf("%-6s parse %8.2f ms  teardown %8.3f ms  %zu allocations\n", names[use_arena],
+               best.parse * 1e3, best.teardown * 1e3, best.allocations);
+    }
+
+    free_token_buffer(tokens);
+    free_lexer(lexer);
+    free(source);
+    return 0;
+}
@@ -0,0 +1,188 @@
+// Parser backend benchmark: parses the same token buffers with the
+// hand-written recursive-descent parser and the generated LALR(1) parser, and
+// reports throughput and memory for each. Workloads are generated files of
+// growing size, one long expression mixing every precedence level, and
+// deeply nested parentheses.
+//
+// Memory is the peak resident size a parse adds, measured in a child process
+// per parse (not available on Windows). Both parsers build the same tree in
+// the same arena; the difference is their working stacks: native frames for
+// recursive descent, a heap stack of states and values for LALR.
+//
+// The largest file is then parsed with the recursive-descent parser split
+// across 1..max_threads threads (parse_program_parallel).
+//
+// usage: bench_parsers [max_mb] [terms] [max_threads]
+
+#include "bench_util.h"
+#include "../lexer/lexer.h"
+#include "../lexer/token_buffer.h"
+#include "../parser/parser.h"
+#include "../utils/parallel.h"
+#ifndef _WIN32
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+// Recursive descent recurses once per parenthesis; stay within a default stack
+#define NESTING_DEPTH 10000
+
+typedef ASTNode* (*ParseFn)(Parser* parser);
+
+typedef struct {
+    const char* name;
+    ParseFn parse;
+} ParserBackend;
+
+static const ParserBackend backends[] = {
+    { "descent", parse_program },
+    { "lalr", parse_program_lalr },
+};
+#define BACKEND_COUNT (sizeof(backends) / sizeof(backends[0]))
+
+static double parse_best(const TokenBuffer* tokens, ParseFn parse, int reps, size_t* ast_bytes) {
+    double best = 1e30;
+    for (int rep = 0; rep < reps; ++rep) {
+        Parser* parser = create_parser_from_tokens(tokens);
+        Arena* arena = create_arena(0);
+        parser->arena = arena;
+        double start = bench_now();
+        ASTNode* root = parse(parser);
+        double elapsed = bench_now() - start;
+        if (!root) {
+            fprintf(stdout, "parse failed\n");
+            exit(1);
+        }
+        if (elapsed < best) best = elapsed;
+        *ast_bytes = arena->bytes;
+        free_arena(arena);
+        free_parser(parser);
+    }
+    return best;
+}
+
+// Peak resident size of a child process that runs one parse (or nothing for
+// a NULL `parse`), in KB (bytes on macOS); -1 if it cannot be measured
+static long child_peak_rss(const TokenBuffer* tokens, ParseFn parse) {
+#ifdef _WIN32
+    (void)tokens;
+    (void)parse;
+    return -1;
+#else
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        size_t ast_bytes = 0;
+        if (parse) parse_best(tokens, parse, 1, &ast_bytes);
+        _exit(0);
+    }
+    int status = 0;
+    struct rusage usage;
+    if (pid < 0 || wait4(pid, &status, 0, &usage) < 0) return -1;
+    return usage.ru_maxrss;
+#endif
+}
+
+static void run_workload(const char* name, const char* source, size_t length) {
+    Lexer* lexer = create_lexer(source);
+    TokenBuffer* tokens = lexer_tokenize(lexer);
+    // Memory first: pages the timed runs leave in this process's heap would
+    // be reused by the children without showing up as growth
+    long baseline = child_peak_rss(tokens, NULL);
+    long peaks[BACKEND_COUNT];
+    for (size_t b = 0; b < BACKEND_COUNT; ++b) peaks[b] = child_peak_rss(tokens, backends[b].parse);
+    for (size_t b = 0; b < BACKEND_COUNT; ++b) {
+        size_t ast_bytes = 0;
+        double best = parse_best(tokens, backends[b].parse, 3, &ast_bytes);
+        printf("%-12s %-8s %10zu %10.2f %8.1f %8.1f %8.1f", name, backends[b].name, tokens->count, best * 1e3,
+               (double)length / (1 << 20) / best, (double)tokens->count / best * 1e-6, (double)ast_bytes / (1 << 20));
+        if (peaks[b] >= 0 && baseline >= 0) {
+            printf(" %9.1f\n", (double)(peaks[b] - baseline) / 1024);
+        } else {
+            printf(" %9s\n", "n/a");
+        }
+    }
+    free_token_buffer(tokens);
+    free_lexer(lexer);
+}
+
+// int main() { int x = 1; int y = <expression>; return y; }
+static char* generate_expression(int nested, size_t terms, size_t* out_len) {
+    static const char* mixed_ops[] = { " + ", " * ", " - ", " / ", " < ", " + ", " * ", " == " };
+    BenchBuffer buf = {0};
+    char term[64];
+    bench_append(&buf, "int main() {\n    int x = 1;\n    int y = ");
+    if (nested) {
+        for (size_t i = 0; i < terms; ++i) bench_append(&buf, "(");
+        bench_append(&buf, "x");
+        for (size_t i = 0; i < terms; ++i) {
+            snprintf(term, sizeof(term), " + %zu)", i);
+            bench_append(&buf, term);
+        }
+    } else {
+        bench_append(&buf, "x");
+        for (size_t i = 1; i < terms; ++i) {
+            snprintf(term, sizeof(term), "%s%s", mixed_ops[i % 8], (i & 1) ? "x" : "7");
+            bench_append(&buf, term);
+        }
+    }
+    bench_append(&buf, ";\n    return y;\n}\n");
+    *out_len = buf.length;
+    return buf.data;
+}
+
+int main(int argc, char* argv[]) {
+    size_t max_mb = argc > 1 ? (size_t)atoll(argv[1]) : 16;
+    size_t terms = argc > 2 ? (size_t)atoll(argv[2]) : 1000000;
+
+    printf("%-12s %-8s %10s %10s %8s %8s %8s %9s\n", "workload", "parser", "tokens", "parse ms", "MB/s", "Mtok/s",
+           "AST MB", "peak +MB");
+    char name[32];
+    size_t length = 0;
+    for (size_t mb = 1; mb <= max_mb; mb *= 4) {
+        char* source = bench_generate_source(mb << 20, 8, &length);
+        snprintf(name, sizeof(name), "%zu MB", mb);
+        run_workload(name, source, length);
+        free(source);
+    }
+
+    char* source = generate_expression(0, terms, &length);
+    run_workload("expression", source, length);
+    free(source);
+
+    source = generate_expression(1, NESTING_DEPTH, &length);
+    run_workload("nested", source, length);
+    free(source);
+
+    int max_threads = argc > 3 ? atoi(argv[3]) : parallel_cpu_count();
+    source = bench_generate_source(max_mb << 20, 8, &length);
+    Lexer* lexer = create_lexer(source);
+    TokenBuffer* tokens = lexer_tokenize(lexer);
+    printf("\n%zu MB parsed in parallel\n%8s %10s %8s\n", max_mb, "threads", "parse ms", "speedup");
+    double single = 0;
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        double best = 1e30;
+        for (int rep = 0; rep < 3; ++rep) {
+            Parser* parser = create_parser_from_tokens(tokens);
+            Arena* arena = create_arena(0);
+            parser->arena = arena;
+            double start = bench_now();
+            ASTNode* root = parse_program_parallel(parser, threads);
+            double elapsed = bench_now() - start;
+            if (!root) {
+                fprintf(stdout, "parse failed\n");
+                return 1;
+            }
+            if (elapsed < best) best = elapsed;
+            free_arena(arena);
+            free_parser(parser);
+        }
+        if (threads == 1) single = best;
+        printf("%8d %10.2f %7.2fx\n", threads, best * 1e3, single / best);
+    }
+    free_token_buffer(tokens);
+    free_lexer(lexer);
+    free(source);
+    return 0;
+}
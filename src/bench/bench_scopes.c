@@ -0,0 +1,96 @@
+// Symbol table benchmark: parses and checks single functions with growing
+// numbers of locals, so the cost of declaring and looking up names in the
+// parser's name table and the analyzer's scopes dominates. Shapes are one
+// flat scope, a block per local (a deep scope chain) and locals redeclared
+// in sibling blocks (scopes opened and closed in turn).
+//
+// "fused ms" parses the same tokens again with the checks made while parsing
+// (parser_enable_semantics), against parse ms + sema ms for the two passes.
+//
+// usage: bench_scopes [max_locals] 2>/dev/null
+
+#include "bench_util.h"
+#include "../lexer/lexer.h"
+#include "../lexer/token_buffer.h"
+#include "../parser/parser.h"
+#include "../parser/ast_pool.h"
+#include "../semantic/semantic_analyzer.h"
+
+typedef enum { FLAT, NESTED, SIBLINGS } ScopeShape;
+
+// int main() { int v0 = 0; int v1 = v0 + 1; ... return v<n-1>; }
+static char* generate_locals(ScopeShape shape, size_t locals) {
+    BenchBuffer buf = {0};
+    char line[128];
+    bench_append(&buf, "int main() {\n    int v0 = 0;\n");
+    for (size_t i = 1; i < locals; ++i) {
+        if (shape == SIBLINGS) {
+            // { int s0 = v0; s0 = s0 + 1; } with the same few names each time
+            snprintf(line, sizeof(line), "    { int s%zu = v0; s%zu = s%zu + %zu; }\n", i % 16, i % 16, i % 16, i);
+        } else {
+            snprintf(line, sizeof(line), "    %sint v%zu = v%zu + 1;\n", shape == NESTED ? "{ " : "", i, i - 1);
+        }
+        bench_append(&buf, line);
+    }
+    bench_append(&buf, "    return v0;\n");
+    for (size_t i = 1; shape == NESTED && i < locals; ++i) bench_append(&buf, "}");
+    bench_append(&buf, "\n}\n");
+    return buf.data;
+}
+
+int main(int argc, char* argv[]) {
+    size_t max_locals = argc > 1 ? (size_t)atoll(argv[1]) : 100000;
+    const char* names[] = { "flat", "nested", "siblings" };
+    printf("%-9s %8s %10s %10s %12s %10s\n", "shape", "locals", "parse ms", "sema ms", "sema ns/local", "fused ms");
+    for (int shape = FLAT; shape <= SIBLINGS; ++shape) {
+        for (size_t locals = 1000; locals <= max_locals; locals *= 10) {
+            char* source = generate_locals((ScopeShape)shape, locals);
+            Lexer* lexer = create_lexer(source);
+            TokenBuffer* tokens = lexer_tokenize(lexer);
+            Parser* parser = create_parser_from_tokens(tokens);
+            Arena* arena = create_arena(0);
+            parser->arena = arena;
+
+            double start = bench_now();
+            ASTNode* root = parse_program(parser);
+            double parse = bench_now() - start;
+            AstPool* pool = root ? ast_pool_build(root) : NULL;
+            if (!pool) {
+                fprintf(stdout, "parse failed\n");
+                return 1;
+            }
+
+            SemanticResult result;
+            start = bench_now();
+            analyze_function_pool(pool, ast_pool_statement(pool, pool->root, 0), &result);
+            double sema = bench_now() - start;
+            if (result.errors) {
+                fprintf(stdout, "semantic error: %s\n", result.first_message);
+                return 1;
+            }
+
+            Parser* fused = create_parser_from_tokens(tokens);
+            Arena* fused_arena = create_arena(0);
+            fused->arena = fused_arena;
+            start = bench_now();
+            root = parser_enable_semantics(fused) ? parse_program(fused) : NULL;
+            double fused_parse = bench_now() - start;
+            if (!root || fused->sema_results[0].errors) {
+                fprintf(stdout, "fused parse failed\n");
+                return 1;
+            }
+            printf("%-9s %8zu %10.2f %10.2f %12.1f %10.2f\n", names[shape], locals, parse * 1e3, sema * 1e3,
+                   sema * 1e9 / (double)locals, fused_parse * 1e3);
+
+            free_ast_pool(pool);
+            free_arena(fused_arena);
+            free_parser(fused);
+            free_arena(arena);
+            free_parser(parser);
+            free_token_buffer(tokens);
+            free_lexer(lexer);
+            free(source);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,67 @@
+#ifndef BENCH_UTIL_H
+#define BENCH_UTIL_H
+
+// Small helpers shared by the benchmark programs in src/bench/. They are
+// static inline, so a bench that does not use one compiles without warnings.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+static inline double bench_now(void) {
+    LARGE_INTEGER freq, now;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (double)now.QuadPart / (double)freq.QuadPart;
+}
+#else
+#include <time.h>
+static inline double bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+#endif
+
+// Appends formatted text to a growable NUL-terminated buffer
+typedef struct {
+    char* data;
+    size_t length;
+    size_t capacity;
+} BenchBuffer;
+
+static inline void bench_append(BenchBuffer* buf, const char* text) {
+    size_t n = strlen(text);
+    if (buf->length + n + 1 > buf->capacity) {
+        buf->capacity = (buf->capacity ? buf->capacity * 2 : 4096) + n;
+        buf->data = realloc(buf->data, buf->capacity);
+    }
+    memcpy(buf->data + buf->length, text, n + 1);
+    buf->length += n;
+}
+
+// Machine-generated style source: one function per `stmts_per_func`
+// statements, until roughly `target_bytes` of text has been produced.
+static inline char* bench_generate_source(size_t target_bytes, size_t stmts_per_func, size_t* out_len) {
+    BenchBuffer buf = {0};
+    char line[256];
+    size_t func = 0;
+    while (buf.length < target_bytes) {
+        snprintf(line, sizeof(line), "int func_%zu() {\n    int accumulator_value = 0;\n", func++);
+        bench_append(&buf, line);
+        for (size_t i = 0; i < stmts_per_func; ++i) {
+            snprintf(line, sizeof(line),
+                     "    int v_%zu = %zu * (accumulator_value + %zu) - 17;\n"
+                     "    if (v_%zu >= 1000) {\n        accumulator_value = accumulator_value + v_%zu / 3;\n    }\n",
+                     i, i, i * 31 + 7, i, i);
+            bench_append(&buf, line);
+        }
+        bench_append(&buf, "    return accumulator_value;\n}\n\n");
+    }
+    *out_len = buf.length;
+    return buf.data;
+}
+
+#endif // BENCH_UTIL_H
@@ -1,259 +1,614 @@
 #include "asm_generator.h"
 #include "../parser/ast.h"
+#include "../parser/ast_pool.h"
+#include "../semantic/semantic_analyzer.h"
+#include "../ir/ir_generator.h"
+#include "../ir/optimizer.h"
+#include "../utils/trace.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdarg.h>
+#include "../utils/parallel.h"
 
-// Helper: lookup stack offset for a local variable
-int lookup_local_offset(AsmGenerator* gen, const char* name);
+// Appends to the generator's private buffer, or writes straight to its file
+static void emit(AsmGenerator* gen, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    if (gen->output) {
+        vfprintf(gen->output, format, args);
+        va_end(args);
+        return;
+    }
+    va_list retry;
+    va_copy(retry, args);
+    int n = vsnprintf(gen->buffer + gen->length, gen->capacity - gen->length, format, args);
+    va_end(args);
+    if (n >= 0 && gen->length + (size_t)n >= gen->capacity) {
+        size_t capacity = gen->capacity ? gen->capacity * 2 : 4096;
+        while (capacity <= gen->length + (size_t)n) capacity *= 2;
+        char* grown = realloc(gen->buffer, capacity);
+        if (!grown) {
+            fprintf(stderr, "[ERROR] Out of memory while generating assembly\n");
+            va_end(retry);
+            return;
+        }
+        gen->buffer = grown;
+        gen->capacity = capacity;
+        vsnprintf(gen->buffer + gen->length, gen->capacity - gen->length, format, retry);
+    }
+    va_end(retry);
+    if (n > 0) gen->length += (size_t)n;
+}
 
 static int next_label(AsmGenerator* gen) {
     return gen->label_counter++;
 }
   
-static void generate_expression(AsmGenerator* gen, ASTNode* node) {
-    if (!node) return;
-    
-    switch (node->type) {
-        case AST_NUMBER:
-            fprintf(gen->output, "    mov rax, %d\n", node->value);
-            break;
+// Work item of the generator's explicit stack. Each node is expanded into
+// the items for its parts, pushed last-first, so code comes out in the same
+// order as a recursive walk while nesting depth only costs heap.
+typedef enum {
+    CG_STATEMENT,      // emit statement `ref`
+    CG_EXPRESSION,     // evaluate expression `ref` into rax
+    CG_PUSH_LEFT,      // left operand is in rax: save it
+    CG_BINOP,          // right operand is in rax: combine with the saved left one
+    CG_STORE_VARIABLE, // store rax into the variable declared or assigned by `ref`
+    CG_STORE_RETURN,   // store rax into __return_value
+    CG_BRANCH_FALSE,   // jump to label_a if rax is zero
+    CG_IF_ELSE,        // end of the then branch of `ref`: jump to label_b, open label_a
+    CG_LOOP_BACK,      // end of a loop body: jump to label_a, open label_b
+    CG_LABEL,          // open label_a
+    CG_FUNCTION_END    // after the body of a function
+} CodegenAction;
 
-        case AST_IDENTIFIER: {
-            int local_offset = lookup_local_offset(gen, node->identifier);
-            if (local_offset != -9999) {
-                fprintf(gen->output, "    mov rax, [rbp%+d]\n", local_offset);
-            } else {
-                fprintf(gen->output, "    mov rax, [rel %s]\n", node->identifier);
-            }
-            break;
-        }
+typedef struct CodegenTask {
+    AstRef ref;
+    CodegenAction action;
+    int label_a;
+    int label_b;
+} CodegenTask;
 
-        case AST_BINARY_OP: {
-            generate_expression(gen, node->binop.left);
-            fprintf(gen->output, "    push rax\n");
-            generate_expression(gen, node->binop.right);
-            fprintf(gen->output, "    mov rbx, rax\n");
-            fprintf(gen->output, "    pop rax\n");
-
-            switch (node->binop.op_type) {
-                case OP_ADD:
-                    fprintf(gen->output, "    add rax, rbx\n");
-                    break;
-                case OP_SUB:
-                    fprintf(gen->output, "    sub rax, rbx\n");
-                    break;
-                case OP_MUL:
-                    fprintf(gen->output, "    imul rax, rbx\n");
-                    break;
-                case OP_DIV:
-                    fprintf(gen->output, "    cqo\n");
-                    fprintf(gen->output, "    idiv rbx\n");
-                    break;
-                case OP_LT:
-                case OP_GT:
-                case OP_LE:
-                case OP_GE:
-                case OP_EQ:
-                case OP_NEQ: {
-                    // Comparison: rax = left, rbx = right
-                    fprintf(gen->output, "    cmp rax, rbx\n");
-                    const char* set_instr = NULL;
-                    switch (node->binop.op_type) {
-                        case OP_LT: set_instr = "setl"; break;
-                        case OP_GT: set_instr = "setg"; break;
-                        case OP_LE: set_instr = "setle"; break;
-                        case OP_GE: set_instr = "setge"; break;
-                        case OP_EQ: set_instr = "sete"; break;
-                        case OP_NEQ: set_instr = "setne"; break;
-                        default: set_instr = "sete"; break;
-                    }
-                    fprintf(gen->output, "    %s al\n", set_instr);
-                    fprintf(gen->output, "    movzx rax, al\n");
-                    break;
-                }
-                default:
-                    break;
+static int push_task(AsmGenerator* gen, CodegenAction action, AstRef ref, int label_a, int label_b) {
+    if ((action == CG_STATEMENT || action == CG_EXPRESSION) && !ref) return 1;
+    if (gen->task_count == gen->task_capacity) {
+        size_t capacity = gen->task_capacity ? gen->task_capacity * 2 : 256;
+        CodegenTask* grown = realloc(gen->tasks, capacity * sizeof(CodegenTask));
+        if (!grown) return 0;
+        gen->tasks = grown;
+        gen->task_capacity = capacity;
+    }
+    CodegenTask* task = &gen->tasks[gen->task_count++];
+    task->ref = ref;
+    task->action = action;
+    task->label_a = label_a;
+    task->label_b = label_b;
+    return 1;
+}
+
+// rax = left, rbx = right
+static void emit_binop(AsmGenerator* gen, BinOpType op) {
+    switch (op) {
+        case OP_ADD:
+            emit(gen, "    add rax, rbx\n");
+            break;
+        case OP_SUB:
+            emit(gen, "    sub rax, rbx\n");
+            break;
+        case OP_MUL:
+            emit(gen, "    imul rax, rbx\n");
+            break;
+        case OP_DIV:
+            emit(gen, "    cqo\n");
+            emit(gen, "    idiv rbx\n");
+            break;
+        case OP_LT:
+        case OP_GT:
+        case OP_LE:
+        case OP_GE:
+        case OP_EQ:
+        case OP_NEQ: {
+            // Comparison: rax = left, rbx = right
+            emit(gen, "    cmp rax, rbx\n");
+            const char* set_instr = NULL;
+            switch (op) {
+                case OP_LT: set_instr = "setl"; break;
+                case OP_GT: set_instr = "setg"; break;
+                case OP_LE: set_instr = "setle"; break;
+                case OP_GE: set_instr = "setge"; break;
+                case OP_EQ: set_instr = "sete"; break;
+                case OP_NEQ: set_instr = "setne"; break;
+                default: set_instr = "sete"; break;
             }
+            emit(gen, "    %s al\n", set_instr);
+            emit(gen, "    movzx rax, al\n");
             break;
         }
-
         default:
             break;
     }
 }
 
-// Helper: allocate stack space for locals
-static void emit_function_prologue(FILE* out, int local_count) {
-    fprintf(out, "    push rbp\n");
-    fprintf(out, "    mov rbp, rsp\n");
-    if (local_count > 0) {
-        fprintf(out, "    sub rsp, %d\n", local_count * 8);
+// rbp-relative address of the frame slot bound to a variable reference
+static int slot_offset(const AstPool* pool, AstRef ref) {
+    return -((int)ast_pool_slot(pool, ref) + 1) * 8;
+}
+
+static int expand_expression(AsmGenerator* gen, const AstPool* pool, AstRef node) {
+    switch (ast_pool_kind(pool, node)) {
+        case AST_NUMBER:
+            emit(gen, "    mov rax, %d\n", (int)ast_pool_field(pool, node, 0));
+            return 1;
+
+        case AST_IDENTIFIER:
+            emit(gen, "    mov rax, [rbp%+d]\n", slot_offset(pool, node));
+            return 1;
+
+        case AST_BINARY_OP:
+            // left; push rax; right; mov rbx, rax; pop rax; op
+            return push_task(gen, CG_BINOP, node, 0, 0) &&
+                   push_task(gen, CG_EXPRESSION, ast_pool_field(pool, node, 1), 0, 0) &&
+                   push_task(gen, CG_PUSH_LEFT, node, 0, 0) &&
+                   push_task(gen, CG_EXPRESSION, ast_pool_field(pool, node, 0), 0, 0);
+
+        default:
+            return 1;
     }
 }
-static void emit_function_epilogue(FILE* out, int local_count) {
+
+// Helper: allocate stack space for locals
+static void emit_function_prologue(AsmGenerator* gen, int local_count) {
+    emit(gen, "    push rbp\n");
+    emit(gen, "    mov rbp, rsp\n");
     if (local_count > 0) {
-        fprintf(out, "    add rsp, %d\n", local_count * 8);
+        emit(gen, "    sub rsp, %d\n", local_count * 8);
     }
-    fprintf(out, "    pop rbp\n");
-    fprintf(out, "    ret\n");
 }
 
-// Helper: lookup stack offset for a local variable
-int lookup_local_offset(AsmGenerator* gen, const char* name) {
-    for (int i = 0; i < gen->local_count; ++i) {
-        if (strcmp(gen->locals[i].name, name) == 0) {
-            return gen->locals[i].offset;
-        }
+// After the body of a function: prints __return_value if it was assigned
+// and releases the frame
+static void emit_function_end(AsmGenerator* gen) {
+    // At the end of main, print __return_value if it was assigned
+    // Only emit print and epilogue/ret ONCE, and only after all code
+    if (gen->has_return_value) {
+        emit(gen, "    mov rdx, qword [rel __return_value]\n");
+        emit(gen, "    lea rcx, [rel fmt]\n");
+        emit(gen, "    call printf\n");
+    }
+    if (gen->local_count > 0) {
+        emit(gen, "    add rsp, %d\n", gen->local_count * 8);
     }
-    return -9999; // Use -9999 for not found
+    emit(gen, "    pop rbp\n");
 }
 
-// Main codegen entry for function
-void generate_assembly(AsmGenerator* gen, ASTNode* ast) {
-    if (!gen || !ast) return;
-    // Emit .data and .text sections only at the start (AST_FUNCTION)
-    // Count locals and fill gen->locals
-    gen->local_count = 0;
-    if (ast->type == AST_FUNCTION) {
-        if (ast->function.body && (ast->function.body->type == AST_BLOCK || ast->function.body->type == AST_COMPOUND)) {
-            for (size_t i = 0; i < ast->function.body->block.count; ++i) {
-                ASTNode* stmt = ast->function.body->block.statements[i];
-                if (stmt && stmt->type == AST_DECLARATION) {
-                    gen->locals[gen->local_count].name = stmt->declaration.name;
-                    gen->locals[gen->local_count].offset = -(gen->local_count + 1) * 8;
-                    gen->local_count++;
-                }
-            }
-        }
-        emit_function_prologue(gen->output, gen->local_count);
-        for (size_t i = 0; i < ast->function.body->block.count; ++i) {
-            ASTNode* stmt = ast->function.body->block.statements[i];
-            if (stmt) {
-                generate_assembly(gen, stmt);
-            }
-        }
-        // At the end of main, print __return_value if it was assigned
-        // Only emit print and epilogue/ret ONCE, and only after all code
-        if (gen->has_return_value) {
-            fprintf(gen->output, "    mov rdx, qword [rel __return_value]\n");
-            fprintf(gen->output, "    lea rcx, [rel fmt]\n");
-            fprintf(gen->output, "    call printf\n");
+// Emits what a statement produces before its parts and queues the parts
+static int expand_statement(AsmGenerator* gen, const AstPool* pool, AstRef ast) {
+    ASTNodeType kind = ast_pool_kind(pool, ast);
+    if (kind == AST_FUNCTION) {
+        AstRef body = ast_pool_field(pool, ast, 1);
+        size_t count = 0;
+        if (body && (ast_pool_kind(pool, body) == AST_BLOCK || ast_pool_kind(pool, body) == AST_COMPOUND)) {
+            count = ast_pool_field(pool, body, 0);
         }
-        if (gen->local_count > 0) {
-            fprintf(gen->output, "    add rsp, %d\n", gen->local_count * 8);
+        gen->local_count = (int)ast_pool_field(pool, ast, 2);
+        emit_function_prologue(gen, gen->local_count);
+        if (!push_task(gen, CG_FUNCTION_END, ast, 0, 0)) return 0;
+        for (size_t i = count; i-- > 0;) {
+            if (!push_task(gen, CG_STATEMENT, ast_pool_statement(pool, body, i), 0, 0)) return 0;
         }
-        fprintf(gen->output, "    pop rbp\n");
-        return;
+        return 1;
     }
-    fprintf(stderr, "[DEBUG] generate_assembly: node type %d\n", ast->type);
-    switch (ast->type) {
+    TRACE(TRACE_CODEGEN, "node", "type=%d offset=%zu", kind, ast_pool_offset(pool, ast));
+    switch (kind) {
         case AST_NUMBER:
         case AST_IDENTIFIER:
         case AST_BINARY_OP:
-            generate_expression(gen, ast);
-            break;
+            return push_task(gen, CG_EXPRESSION, ast, 0, 0);
 
-        case AST_DECLARATION:
-            fprintf(stderr, "[DEBUG] generate_assembly: DECLARATION %s\n", ast->declaration.name);
-            fprintf(gen->output, "    ; declare %s\n", ast->declaration.name);
-            int local_offset = lookup_local_offset(gen, ast->declaration.name);
-            if (ast->declaration.init) {
-                generate_expression(gen, ast->declaration.init);
-                if (local_offset != -9999) {
-                    fprintf(gen->output, "    mov [rbp%+d], rax\n", local_offset);
-                } else {
-                    fprintf(gen->output, "    mov [rel %s], rax\n", ast->declaration.name);
-                }
-            } else {
-                if (local_offset != -9999) {
-                    fprintf(gen->output, "    mov [rbp%+d], 0\n", local_offset);
-                } else {
-                    fprintf(gen->output, "    mov [rel %s], 0\n", ast->declaration.name);
-                }
+        case AST_DECLARATION: {
+            AstRef init = ast_pool_field(pool, ast, 1);
+            emit(gen, "    ; declare %s\n", atom_name(ast_pool_field(pool, ast, 0)));
+            if (init) {
+                return push_task(gen, CG_STORE_VARIABLE, ast, 0, 0) &&
+                       push_task(gen, CG_EXPRESSION, init, 0, 0);
             }
-            break;
+            emit(gen, "    mov qword [rbp%+d], 0\n", slot_offset(pool, ast));
+            return 1;
+        }
         case AST_RETURN:
-            fprintf(stderr, "[DEBUG] generate_assembly: RETURN\n");
-            generate_expression(gen, ast->return_stmt.expr);
-            // Save result to __return_value for printing, but DO NOT emit epilogue/ret here
-fprintf(gen->output, "    mov [rel __return_value], rax\n");
-
-            gen->has_return_value = 1;
-            break;
+            return push_task(gen, CG_STORE_RETURN, ast, 0, 0) &&
+                   push_task(gen, CG_EXPRESSION, ast_pool_field(pool, ast, 0), 0, 0);
 
         case AST_ASSIGNMENT:
-            fprintf(stderr, "[DEBUG] generate_assembly: ASSIGNMENT %s\n", ast->assignment.name);
-            generate_expression(gen, ast->assignment.value);
-            local_offset = lookup_local_offset(gen, ast->assignment.name);
-            if (local_offset != -9999) {
-                fprintf(gen->output, "    mov [rbp%+d], rax\n", local_offset);
-            } else {
-                fprintf(gen->output, "    mov [rel %s], rax\n", ast->assignment.name);
-            }
-            // Track if __return_value is assigned
-            if (strcmp(ast->assignment.name, "__return_value") == 0) {
-                gen->has_return_value = 1;
+            return push_task(gen, CG_STORE_VARIABLE, ast, 0, 0) &&
+                   push_task(gen, CG_EXPRESSION, ast_pool_field(pool, ast, 1), 0, 0);
+
+        case AST_PROGRAM: {
+            size_t count = ast_pool_field(pool, ast, 0);
+            for (size_t i = 0; i < count; ++i) {
+                generate_function_pool(gen, pool, ast_pool_statement(pool, ast, i));
             }
-            break;
+            return 1;
+        }
 
-        case AST_COMPOUND:
-            fprintf(stderr, "[DEBUG] generate_assembly: COMPOUND with %zu statements\n", ast->block.count);
-            for (size_t i = 0; i < ast->block.count; ++i) {
-                if (ast->block.statements[i]) {
-                    generate_assembly(gen, ast->block.statements[i]);
-                } else {
-                    fprintf(stderr, "[DEBUG] generate_assembly: NULL child in COMPOUND at %zu\n", i);
+        case AST_BLOCK:
+        case AST_COMPOUND: {
+            size_t count = ast_pool_field(pool, ast, 0);
+            for (size_t i = count; i-- > 0;) {
+                AstRef stmt = ast_pool_statement(pool, ast, i);
+                if (!stmt) {
+                    TRACE(TRACE_CODEGEN, "null-statement", "index=%zu", i);
+                } else if (!push_task(gen, CG_STATEMENT, stmt, 0, 0)) {
+                    return 0;
                 }
             }
-            break;
+            return 1;
+        }
 
         case AST_IF: {
-            fprintf(stderr, "[DEBUG] generate_assembly: IF\n");
             int label_else = next_label(gen);
             int label_end = next_label(gen);
-            generate_expression(gen, ast->if_stmt.condition);
-            fprintf(gen->output, "    cmp rax, 0\n");
-            fprintf(gen->output, "    je .L%d\n", label_else);
-            generate_assembly(gen, ast->if_stmt.then_branch);
-            fprintf(gen->output, "    jmp .L%d\n", label_end);
-            fprintf(gen->output, ".L%d:\n", label_else);
-            if (ast->if_stmt.else_branch) {
-                generate_assembly(gen, ast->if_stmt.else_branch);
-            }
-            fprintf(gen->output, ".L%d:\n", label_end);
-            break;
+            return push_task(gen, CG_LABEL, ast, label_end, 0) &&
+                   push_task(gen, CG_STATEMENT, ast_pool_field(pool, ast, 2), 0, 0) &&
+                   push_task(gen, CG_IF_ELSE, ast, label_else, label_end) &&
+                   push_task(gen, CG_STATEMENT, ast_pool_field(pool, ast, 1), 0, 0) &&
+                   push_task(gen, CG_BRANCH_FALSE, ast, label_else, 0) &&
+                   push_task(gen, CG_EXPRESSION, ast_pool_field(pool, ast, 0), 0, 0);
         }
         case AST_WHILE: {
-            fprintf(stderr, "[DEBUG] generate_assembly: WHILE\n");
             int label_start = next_label(gen);
             int label_end = next_label(gen);
-            fprintf(gen->output, ".L%d:\n", label_start);
-            generate_expression(gen, ast->while_stmt.condition);
-            fprintf(gen->output, "    cmp rax, 0\n");
-            fprintf(gen->output, "    je .L%d\n", label_end);
-            generate_assembly(gen, ast->while_stmt.body);
-            fprintf(gen->output, "    jmp .L%d\n", label_start);
-            fprintf(gen->output, ".L%d:\n", label_end);
+            emit(gen, ".L%d:\n", label_start);
+            return push_task(gen, CG_LOOP_BACK, ast, label_start, label_end) &&
+                   push_task(gen, CG_STATEMENT, ast_pool_field(pool, ast, 1), 0, 0) &&
+                   push_task(gen, CG_BRANCH_FALSE, ast, label_end, 0) &&
+                   push_task(gen, CG_EXPRESSION, ast_pool_field(pool, ast, 0), 0, 0);
+        }
+        default:
+            fprintf(stderr, "[WARNING] generate_assembly: Unknown AST node type %d\n", (int)kind);
+            return 1;
+    }
+}
+
+// Emits one node; a function emits its prologue, body and exit sequence.
+// Runs its own work loop above whatever the generator has queued already.
+static void generate_node(AsmGenerator* gen, const AstPool* pool, AstRef ast) {
+    size_t base = gen->task_count;
+    int ok = push_task(gen, CG_STATEMENT, ast, 0, 0);
+    while (ok && gen->task_count > base) {
+        CodegenTask task = gen->tasks[--gen->task_count];
+        switch (task.action) {
+            case CG_STATEMENT:
+                ok = expand_statement(gen, pool, task.ref);
+                break;
+            case CG_EXPRESSION:
+                ok = expand_expression(gen, pool, task.ref);
+                break;
+            case CG_PUSH_LEFT:
+                emit(gen, "    push rax\n");
+                break;
+            case CG_BINOP:
+                emit(gen, "    mov rbx, rax\n");
+                emit(gen, "    pop rax\n");
+                emit_binop(gen, ast_pool_op(pool, task.ref));
+                break;
+            case CG_STORE_VARIABLE:
+                emit(gen, "    mov [rbp%+d], rax\n", slot_offset(pool, task.ref));
+                // Track if __return_value is assigned
+                if (ast_pool_kind(pool, task.ref) == AST_ASSIGNMENT &&
+                    ast_pool_field(pool, task.ref, 0) == gen->return_value_atom) {
+                    gen->has_return_value = 1;
+                }
+                break;
+            case CG_STORE_RETURN:
+                // Save result to __return_value for printing, but DO NOT emit epilogue/ret here
+                emit(gen, "    mov [rel __return_value], rax\n");
+                gen->has_return_value = 1;
+                break;
+            case CG_BRANCH_FALSE:
+                emit(gen, "    cmp rax, 0\n");
+                emit(gen, "    je .L%d\n", task.label_a);
+                break;
+            case CG_IF_ELSE:
+                emit(gen, "    jmp .L%d\n", task.label_b);
+                emit(gen, ".L%d:\n", task.label_a);
+                break;
+            case CG_LOOP_BACK:
+                emit(gen, "    jmp .L%d\n", task.label_a);
+                emit(gen, ".L%d:\n", task.label_b);
+                break;
+            case CG_LABEL:
+                emit(gen, ".L%d:\n", task.label_a);
+                break;
+            case CG_FUNCTION_END:
+                emit_function_end(gen);
+                break;
+        }
+    }
+    if (!ok) {
+        fprintf(stderr, "[ERROR] Out of memory while generating assembly\n");
+        gen->task_count = base;
+    }
+}
+
+// Lowering IR to x86-64. Live temps form a stack (see ir_generator.h), so a
+// temp's place is fixed by its depth on it: the first IR_TEMP_REGISTERS
+// depths are registers, deeper temps go on the machine stack. Only
+// caller-saved registers are used; rax, rdx (division) and r11 are scratch.
+#define IR_TEMP_REGISTERS 4
+static const char* const temp_registers[IR_TEMP_REGISTERS] = { "rcx", "r8", "r9", "r10" };
+
+typedef struct IRLowering {
+    AsmGenerator* gen;
+    size_t depth;  // live temps
+} IRLowering;
+
+static int is_register(const char* operand) {
+    return operand[0] == 'r';
+}
+
+// Text of source operand i of `instr`. A temp is taken off the temp stack;
+// one on the machine stack is popped into `scratch`.
+static const char* lower_source(IRLowering* lower, const IRInstruction* instr, unsigned i, const char* scratch,
+                                char* text, size_t size) {
+    uint32_t value = instr->operands[i];
+    switch ((IROperandKind)instr->kinds[i]) {
+        case IR_OPERAND_TEMP:
+            if (--lower->depth < IR_TEMP_REGISTERS) return temp_registers[lower->depth];
+            emit(lower->gen, "    pop %s\n", scratch);
+            return scratch;
+        case IR_OPERAND_VAR:
+            snprintf(text, size, "qword [rbp%+d]", -((int)value + 1) * 8);
+            return text;
+        case IR_OPERAND_IMM:
+            snprintf(text, size, "%d", (int)value);
+            return text;
+        default:
+            return "0";
+    }
+}
+
+// Register the next temp is computed into: its own, or rax if it will be spilled
+static const char* result_register(const IRLowering* lower) {
+    return lower->depth < IR_TEMP_REGISTERS ? temp_registers[lower->depth] : "rax";
+}
+
+// Defines the next temp from `reg`
+static void lower_result(IRLowering* lower, const char* reg) {
+    if (lower->depth < IR_TEMP_REGISTERS) {
+        if (strcmp(reg, temp_registers[lower->depth]) != 0) {
+            emit(lower->gen, "    mov %s, %s\n", temp_registers[lower->depth], reg);
+        }
+    } else {
+        emit(lower->gen, "    push %s\n", reg);
+    }
+    lower->depth++;
+}
+
+static void lower_binop(IRLowering* lower, const IRInstruction* instr) {
+    AsmGenerator* gen = lower->gen;
+    char right_text[32], left_text[32];
+    // The right operand was defined last, so it is above the left one
+    const char* right = lower_source(lower, instr, 2, "r11", right_text, sizeof(right_text));
+    const char* left = lower_source(lower, instr, 1, "rax", left_text, sizeof(left_text));
+    // The result takes the left operand's place: compute in its register when it has one
+    const char* acc = "rax";
+    if (instr->type != IR_DIV && is_register(left) && strcmp(left, "rax") != 0) {
+        acc = left;
+    } else if (strcmp(left, "rax") != 0) {
+        emit(gen, "    mov rax, %s\n", left);
+    }
+    const char* set_instr = NULL;
+    switch ((IRType)instr->type) {
+        case IR_ADD: emit(gen, "    add %s, %s\n", acc, right); break;
+        case IR_SUB: emit(gen, "    sub %s, %s\n", acc, right); break;
+        case IR_MUL:
+            if (instr->kinds[2] == IR_OPERAND_IMM) {
+                emit(gen, "    imul %s, %s, %s\n", acc, acc, right);
+            } else {
+                emit(gen, "    imul %s, %s\n", acc, right);
+            }
+            break;
+        case IR_DIV:
+            if (instr->kinds[2] == IR_OPERAND_IMM) {
+                emit(gen, "    mov r11, %s\n", right);
+                right = "r11";
+            }
+            emit(gen, "    cqo\n");
+            emit(gen, "    idiv %s\n", right);
+            break;
+        case IR_LT: set_instr = "setl"; break;
+        case IR_GT: set_instr = "setg"; break;
+        case IR_LE: set_instr = "setle"; break;
+        case IR_GE: set_instr = "setge"; break;
+        case IR_EQ: set_instr = "sete"; break;
+        case IR_NEQ: set_instr = "setne"; break;
+        default: break;
+    }
+    if (set_instr) {
+        emit(gen, "    cmp %s, %s\n", acc, right);
+        emit(gen, "    %s al\n", set_instr);
+        emit(gen, "    movzx %s, al\n", acc);
+    }
+    lower_result(lower, acc);
+}
+
+static void lower_instruction(IRLowering* lower, const IRInstruction* instr) {
+    AsmGenerator* gen = lower->gen;
+    char text[32], dest[32];
+    const char* source;
+    switch ((IRType)instr->type) {
+        case IR_LOAD_CONST:
+        case IR_LOAD_VAR: {
+            // Only what optimize_ir left in place
+            const char* reg = result_register(lower);
+            emit(gen, "    mov %s, %s\n", reg, lower_source(lower, instr, 1, "rax", text, sizeof(text)));
+            lower_result(lower, reg);
             break;
         }
+        case IR_ASSIGN:
+            source = lower_source(lower, instr, 1, "rax", text, sizeof(text));
+            if (instr->kinds[1] == IR_OPERAND_VAR) {
+                emit(gen, "    mov rax, %s\n", source);
+                source = "rax";
+            }
+            lower_source(lower, instr, 0, "rax", dest, sizeof(dest));
+            emit(gen, "    mov %s, %s\n", dest, source);
+            break;
+        case IR_RETURN:
+            // Stores the result for printing, but does not leave the function
+            source = lower_source(lower, instr, 1, "rax", text, sizeof(text));
+            if (instr->kinds[1] == IR_OPERAND_VAR) {
+                emit(gen, "    mov rax, %s\n", source);
+                source = "rax";
+            }
+            emit(gen, "    mov qword [rel __return_value], %s\n", source);
+            gen->has_return_value = 1;
+            break;
+        case IR_JUMP_IF_FALSE:
+            source = lower_source(lower, instr, 1, "rax", text, sizeof(text));
+            if (instr->kinds[1] == IR_OPERAND_IMM) {
+                if (instr->operands[1] == 0) emit(gen, "    jmp .L%u\n", instr->operands[0]);
+                break;
+            }
+            emit(gen, "    cmp %s, 0\n", source);
+            emit(gen, "    je .L%u\n", instr->operands[0]);
+            break;
+        case IR_JUMP:
+            emit(gen, "    jmp .L%u\n", instr->operands[0]);
+            break;
+        case IR_LABEL:
+            emit(gen, ".L%u:\n", instr->operands[0]);
+            break;
         default:
-            fprintf(stderr, "[WARNING] generate_assembly: Unknown AST node type %d\n", (int)ast->type);
+            lower_binop(lower, instr);
             break;
     }
 }
 
+// Compiles a function through the IR: prologue, lowered body, exit sequence
+static void generate_function_ir(AsmGenerator* gen, const AstPool* pool, AstRef function) {
+    gen->local_count = (int)ast_pool_field(pool, function, 2);
+    emit_function_prologue(gen, gen->local_count);
+    IRProgram program = {0};
+    if (generate_ir_program(pool, ast_pool_field(pool, function, 1), &program)) {
+        optimize_ir(&program);
+        IRLowering lower = { gen, 0 };
+        for (size_t i = 0; i < program.count; ++i) lower_instruction(&lower, &program.code[i]);
+    } else {
+        fprintf(stderr, "[ERROR] Out of memory while generating assembly\n");
+    }
+    free_ir_program(&program);
+    emit_function_end(gen);
+}
+
+// Main codegen entry for function
+void generate_assembly_pool(AsmGenerator* gen, const AstPool* pool, AstRef ast) {
+    if (!gen || !pool) return;
+    generate_node(gen, pool, ast);
+}
+
+void generate_function_pool(AsmGenerator* gen, const AstPool* pool, AstRef function) {
+    if (!gen || !pool || !function) return;
+    emit(gen, "%s:\n", atom_name(ast_pool_field(pool, function, 0)));
+    if (gen->backend == CODEGEN_IR) {
+        generate_function_ir(gen, pool, function);
+    } else {
+        generate_node(gen, pool, function);
+    }
+    // Print __return_value at the end if assigned
+    if (gen->has_return_value) {
+        emit(gen, "    mov rdx, qword [rel __return_value]\n");
+        emit(gen, "    lea rcx, [rel fmt]\n");
+        emit(gen, "    call printf\n");
+    }
+    emit(gen, "    ret\n");
+}
+
+typedef struct CodegenJob {
+    const AstPool* pool;
+    AstRef program;
+    AsmGenerator** generators;
+} CodegenJob;
+
+static void generate_function_task(void* context, size_t index) {
+    CodegenJob* job = context;
+    generate_function_pool(job->generators[index], job->pool, ast_pool_statement(job->pool, job->program, index));
+}
+
+int generate_program_pool(FILE* output, const AstPool* pool, int threads, CodegenBackend backend) {
+    AstRef program = pool->root;
+    if (!program || ast_pool_kind(pool, program) != AST_PROGRAM) return 0;
+    size_t count = ast_pool_field(pool, program, 0);
+    AsmGenerator** generators = calloc(count ? count : 1, sizeof(AsmGenerator*));
+    int ok = generators != NULL;
+    // Generators are created here, on the calling thread: creating one interns a name
+    for (size_t i = 0; ok && i < count; ++i) {
+        ok = (generators[i] = create_asm_generator(NULL)) != NULL;
+        if (ok) generators[i]->backend = backend;
+    }
+    if (ok) {
+        CodegenJob job = { pool, program, generators };
+        parallel_for(count, threads, generate_function_task, &job);
+        for (size_t i = 0; i < count; ++i) fwrite(generators[i]->buffer, 1, generators[i]->length, output);
+    }
+    for (size_t i = 0; generators && i < count; ++i) free_asm_generator(generators[i]);
+    free(generators);
+    return ok;
+}
+
+void generate_program_header(FILE* output) {
+    fprintf(output, "section .data\n");
+    fprintf(output, "__return_value dq 0\n");
+    fprintf(output, "fmt db 'Result: %%lld', 10, 0\n");
+
+    // Variables live in the frame slots semantic analysis bound them to,
+    // so the data section holds nothing per variable
+    fprintf(output, "section .text\n");
+    fprintf(output, "global main\n");
+    fprintf(output, "extern printf\n");
+}
+
+void generate_assembly(AsmGenerator* gen, ASTNode* ast) {
+    if (!gen || !ast) return;
+    AstPool* pool = ast_pool_build(ast);
+    if (!pool) {
+        fprintf(stderr, "[ERROR] generate_assembly: out of memory building the AST pool\n");
+        return;
+    }
+    analyze_semantics_pool(pool, 1);
+    generate_node(gen, pool, pool->root);
+    free_ast_pool(pool);
+}
+
 AsmGenerator* create_asm_generator(FILE* output) {
     AsmGenerator* gen = malloc(sizeof(AsmGenerator));
     if (!gen) return NULL;
     gen->output = output;
+    gen->backend = CODEGEN_IR;
     gen->temp_counter = 0;
     gen->label_counter = 0;
     gen->has_return_value = 0; // Initialize the flag
     gen->emitted_sections = 0; // Initialize emitted_sections flag
+    gen->local_count = 0;
+    gen->return_value_atom = intern_cstr("__return_value");
+    if (gen->return_value_atom == ATOM_NONE) {
+        free(gen);
+        return NULL;
+    }
+    gen->buffer = NULL;
+    gen->length = 0;
+    gen->capacity = 0;
+    gen->tasks = NULL;
+    gen->task_count = 0;
+    gen->task_capacity = 0;
     return gen;
 }
 
 void free_asm_generator(AsmGenerator* gen) {
-    if (gen) free(gen);
+    if (gen) {
+        free(gen->buffer);
+        free(gen->tasks);
+        free(gen);
+    }
 }
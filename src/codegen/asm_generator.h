@@ -2,28 +2,52 @@
 #define ASM_GENERATOR_H
 
 #include "../parser/ast.h"
+#include "../parser/ast_pool.h"
 #include <stdio.h>
 
-#define MAX_LOCALS 128 // Define MAX_LOCALS or adjust as needed
-typedef struct LocalVar {
-    const char* name;
-    int offset;
-} LocalVar;
+// How functions are compiled. CODEGEN_IR builds each function's IR
+// (generate_ir_program), optimizes it (optimize_ir) and lowers it to x86-64;
+// CODEGEN_AST emits code straight from the AST, as the compiler did before
+// it had an IR backend, and is kept as a fallback.
+typedef enum {
+    CODEGEN_IR,
+    CODEGEN_AST
+} CodegenBackend;
+
 typedef struct {
     FILE* output;
+    CodegenBackend backend;      // CODEGEN_IR unless changed after creation
     int temp_counter;
     int label_counter;
     int has_return_value; // Track if __return_value is assigned
     int emitted_sections; // Track if .data/.text emitted
-    LocalVar locals[MAX_LOCALS]; // Add locals array to AsmGenerator
-    int local_count;             // Track number of locals
+    int local_count;             // frame slots of the current function
+    Atom return_value_atom;      // "__return_value", interned once
+    char* buffer;                // output collected when `output` is NULL
+    size_t length;
+    size_t capacity;
+    struct CodegenTask* tasks;   // explicit work stack of the tree walk
+    size_t task_count;
+    size_t task_capacity;
 } AsmGenerator;
 
-// Create and destroy generator
+// Create and destroy generator. A NULL output collects the assembly in the
+// generator's buffer instead, so that several can run concurrently.
 AsmGenerator* create_asm_generator(FILE* output);
 void free_asm_generator(AsmGenerator* generator);
 
-// Main code generation function
-void generate_assembly(AsmGenerator* generator, ASTNode* ast);
+// Main code generation function. Variables live in the frame slots semantic
+// analysis bound them to, so a pool must have been checked first.
+void generate_assembly(AsmGenerator* generator, ASTNode* ast);  // copies the tree into an AstPool and checks it first
+void generate_assembly_pool(AsmGenerator* generator, const AstPool* pool, AstRef ast);
+// Emits `name:`, the function body and its exit sequence, with the
+// generator's backend
+void generate_function_pool(AsmGenerator* generator, const AstPool* pool, AstRef function);
+// Generates every function of an AST_PROGRAM root with `backend`, each into
+// a private buffer on up to `threads` threads (<= 0: one per CPU), and
+// writes them to `output` in source order. Returns 0 if out of memory.
+int generate_program_pool(FILE* output, const AstPool* pool, int threads, CodegenBackend backend);
+// Writes the data and text section preamble that precedes the functions
+void generate_program_header(FILE* output);
 
 #endif // ASM_GENERATOR_H
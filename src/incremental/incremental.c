@@ -0,0 +1,438 @@
+#include "incremental.h"
+#include "../parser/parser.h"
+#include "../parser/ast_pool.h"
+#include "../codegen/asm_generator.h"
+#include "../utils/trace.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Drops what compile_unit produced, keeping the text and tokens
+static void clear_unit(IncrementalUnit* unit) {
+    free_arena(unit->arena);
+    unit->arena = NULL;
+    unit->function = NULL;
+    if (unit->names) free_symbol_table(unit->names);
+    unit->names = NULL;
+    memset(&unit->sema, 0, sizeof(unit->sema));
+    free(unit->assembly);
+    unit->assembly = NULL;
+    unit->assembly_length = 0;
+}
+
+static void free_unit(IncrementalUnit* unit) {
+    if (unit) {
+        clear_unit(unit);
+        free(unit->text);
+        free_token_buffer(unit->tokens);
+        free(unit);
+    }
+}
+
+static TokenBuffer* lex_text(const char* text, size_t length) {
+    Lexer lexer;
+    lexer_init_span(&lexer, text, length);
+    return lexer_tokenize(&lexer);
+}
+
+// Parses a unit as one definition, then checks and compiles it. `earlier`
+// holds the names declared before the unit; without them the parse is a
+// quiet attempt, and a unit that fails it is marked as needing them. A unit
+// that does not parse is kept without a function; incremental_check reports
+// it. Returns 0 if out of memory.
+static int compile_unit(IncrementalUnit* unit, SymbolTable* earlier) {
+    clear_unit(unit);
+    // Most definitions are small: size the arena by the text, not the default
+    unit->arena = create_arena(unit->length * 8 < 4096 ? 4096 : unit->length * 8);
+    Parser* parser = unit->arena ? create_parser_from_tokens(unit->tokens) : NULL;
+    if (!parser) return 0;
+    parser->arena = unit->arena;
+    parser->quiet = earlier == NULL;
+    if (earlier) parser->names->parent = earlier;
+    ASTNode* program = parse_program(parser);
+    unit->names = parser->names;  // taken over by the unit
+    unit->names->parent = NULL;
+    parser->names = NULL;
+    free_parser(parser);
+    int parsed = program && program->block.count == 1;
+    if (!earlier) unit->needs_names = !parsed;
+    if (!parsed) return 1;
+    unit->function = program->block.statements[0];
+
+    AstPool* pool = ast_pool_build(unit->function);
+    if (!pool) return 0;
+    analyze_function_pool(pool, pool->root, &unit->sema);
+    int ok = 1;
+    if (unit->sema.errors == 0) {
+        AsmGenerator* gen = create_asm_generator(NULL);
+        ok = gen != NULL;
+        if (ok) {
+            generate_function_pool(gen, pool, pool->root);
+            unit->assembly = gen->buffer;  // taken over by the unit
+            unit->assembly_length = gen->length;
+            gen->buffer = NULL;
+            free_asm_generator(gen);
+        }
+    }
+    free_ast_pool(pool);
+    return ok;
+}
+
+// Takes ownership of `text`, and of `tokens` if given (otherwise lexes it)
+static IncrementalUnit* create_unit(char* text, size_t length, TokenBuffer* tokens) {
+    IncrementalUnit* unit = calloc(1, sizeof(IncrementalUnit));
+    if (!unit) {
+        free(text);
+        free_token_buffer(tokens);
+        return NULL;
+    }
+    unit->text = text;
+    unit->length = length;
+    for (const char* p = text; (p = memchr(p, '\n', length - (size_t)(p - text))) != NULL; ++p) {
+        unit->newlines++;
+    }
+    unit->tokens = tokens ? tokens : lex_text(text, length);
+    if (!unit->tokens || !compile_unit(unit, NULL)) {
+        free_unit(unit);
+        return NULL;
+    }
+    return unit;
+}
+
+// Splits a token stream into definitions by brace matching: a definition
+// ends at the '}' that closes its outermost '{', and the next one starts at
+// the following token. starts[i] is the offset where definition i begins;
+// starts[0] is 0, so leading whitespace stays with the first definition.
+// Returns the number of definitions, or (size_t)-1 if out of memory.
+static size_t split_definitions(const TokenBuffer* tokens, size_t** out_starts) {
+    size_t* starts = NULL;
+    size_t count = 0, capacity = 0;
+    int depth = 0, open = 0;
+    for (size_t i = 0; i + 1 < tokens->count; ++i) {  // the last token is TOKEN_EOF
+        if (!open) {
+            if (count == capacity) {
+                capacity = capacity ? capacity * 2 : 8;
+                size_t* grown = realloc(starts, capacity * sizeof(size_t));
+                if (!grown) {
+                    free(starts);
+                    return (size_t)-1;
+                }
+                starts = grown;
+            }
+            starts[count] = count ? tokens->offsets[i] : 0;
+            count++;
+            open = 1;
+        }
+        if (tokens->types[i] == TOKEN_LBRACE) {
+            depth++;
+        } else if (tokens->types[i] == TOKEN_RBRACE && depth > 0 && --depth == 0) {
+            open = 0;
+        }
+    }
+    *out_starts = starts;
+    return count;
+}
+
+// Concatenated text of units [first, end)
+static char* join_units(const IncrementalSession* session, size_t first, size_t end, size_t* out_length) {
+    size_t length = 0;
+    for (size_t i = first; i < end; ++i) length += session->units[i]->length;
+    char* text = malloc(length ? length : 1);
+    if (!text) return NULL;
+    size_t at = 0;
+    for (size_t i = first; i < end; ++i) {
+        memcpy(text + at, session->units[i]->text, session->units[i]->length);
+        at += session->units[i]->length;
+    }
+    *out_length = length;
+    return text;
+}
+
+// Region text after the edit, which lies at `offset` within the region
+static char* edit_region(const char* old_text, size_t old_length, size_t offset, size_t removed,
+                         const char* text, size_t inserted, size_t* out_length) {
+    size_t length = old_length - removed + inserted;
+    char* region = malloc(length ? length : 1);
+    if (!region) return NULL;
+    memcpy(region, old_text, offset);
+    memcpy(region + offset, text, inserted);
+    memcpy(region + offset + inserted, old_text + offset + removed, old_length - offset - removed);
+    *out_length = length;
+    return region;
+}
+
+// Replaces units [first, end) with `fresh`
+static int splice_units(IncrementalSession* session, size_t first, size_t end, IncrementalUnit** fresh, size_t count) {
+    size_t new_count = session->count - (end - first) + count;
+    if (new_count > session->capacity) {
+        size_t capacity = session->capacity ? session->capacity : 16;
+        while (capacity < new_count) capacity *= 2;
+        IncrementalUnit** grown = realloc(session->units, capacity * sizeof(IncrementalUnit*));
+        if (!grown) return 0;
+        session->units = grown;
+        session->capacity = capacity;
+    }
+    for (size_t i = first; i < end; ++i) free_unit(session->units[i]);
+    memmove(session->units + first + count, session->units + end, (session->count - end) * sizeof(IncrementalUnit*));
+    memcpy(session->units + first, fresh, count * sizeof(IncrementalUnit*));
+    session->count = new_count;
+    return 1;
+}
+
+static void add_names(SymbolTable* into, const SymbolTable* from) {
+    for (const SymbolEntry* entry = from ? from->symbols : NULL; entry; entry = entry->next) {
+        add_symbol(into, entry->name);
+    }
+}
+
+// Parses the units from `first` on that need the names declared before them
+// again, as a full parse of the file would see them, up to the first that
+// still fails. Units [first, end) were just parsed; returns how many units
+// from `end` on were parsed again, or (size_t)-1 if out of memory.
+static size_t resolve_units(const IncrementalSession* session, size_t first, size_t end) {
+    size_t i = first;
+    while (i < session->count && !session->units[i]->needs_names) i++;
+    if (i == session->count) return 0;
+
+    SymbolTable* names = create_symbol_table(NULL);
+    if (!names) return (size_t)-1;
+    for (size_t k = 0; k < i; ++k) add_names(names, session->units[k]->names);
+    size_t parsed = 0;
+    for (; i < session->count; ++i) {
+        IncrementalUnit* unit = session->units[i];
+        if (unit->needs_names) {
+            if (!compile_unit(unit, names)) {
+                parsed = (size_t)-1;
+                break;
+            }
+            if (i >= end) parsed++;
+            if (!unit->function) break;
+        }
+        add_names(names, unit->names);
+    }
+    free_symbol_table(names);
+    return parsed;
+}
+
+int incremental_edit(IncrementalSession* session, size_t offset, size_t removed, const char* text, size_t inserted) {
+    if (offset > session->length || removed > session->length - offset) return 0;
+
+    // Units touching [offset, offset + removed], including both ends
+    size_t first = session->count, end = 0, first_start = 0, start = 0;
+    for (size_t i = 0; i < session->count && start <= offset + removed; ++i) {
+        size_t length = session->units[i]->length;
+        if (first == session->count && start + length >= offset) {
+            first = i;
+            first_start = start;
+        }
+        end = i + 1;
+        start += length;
+    }
+    if (first == session->count) first = end = session->count;
+
+    char* region = NULL;
+    size_t region_length = 0;
+    TokenBuffer* tokens = NULL;
+    size_t* starts = NULL;
+    size_t definitions = 0;
+    for (;;) {
+        size_t old_length = 0;
+        char* old_text = join_units(session, first, end, &old_length);
+        if (!old_text) return 0;
+        region = edit_region(old_text, old_length, offset - first_start, removed, text, inserted, &region_length);
+        free(old_text);
+        if (!region) return 0;
+        tokens = lex_text(region, region_length);
+        definitions = tokens ? split_definitions(tokens, &starts) : (size_t)-1;
+        if (definitions == (size_t)-1) {
+            free_token_buffer(tokens);
+            free(region);
+            return 0;
+        }
+        // Nothing but whitespace left: fold it into a neighbouring definition
+        if (definitions > 0 || (first == 0 && end == session->count)) break;
+        free_token_buffer(tokens);
+        free(region);
+        if (first > 0) {
+            first--;
+            first_start -= session->units[first]->length;
+        } else {
+            end++;
+        }
+    }
+    TRACE(TRACE_PARSER, "incremental", "units=%zu..%zu definitions=%zu bytes=%zu", first, end, definitions,
+          region_length);
+
+    // One definition keeps the region as is; several are lexed again one by one
+    size_t count = definitions ? definitions : 1;
+    IncrementalUnit** fresh = calloc(count, sizeof(IncrementalUnit*));
+    int ok = fresh != NULL;
+    session->relexed_bytes = region_length;
+    if (ok && count == 1) {
+        ok = (fresh[0] = create_unit(region, region_length, tokens)) != NULL;
+    } else if (ok) {
+        free_token_buffer(tokens);
+        for (size_t i = 0; ok && i < count; ++i) {
+            size_t piece_end = i + 1 < count ? starts[i + 1] : region_length;
+            size_t length = piece_end - starts[i];
+            char* piece = malloc(length ? length : 1);
+            ok = piece != NULL;
+            if (ok) {
+                memcpy(piece, region + starts[i], length);
+                ok = (fresh[i] = create_unit(piece, length, NULL)) != NULL;
+            }
+        }
+        session->relexed_bytes += region_length;
+        free(region);
+    } else {
+        free_token_buffer(tokens);
+        free(region);
+    }
+    free(starts);
+
+    if (ok) ok = splice_units(session, first, end, fresh, count);
+    if (!ok) {
+        for (size_t i = 0; fresh && i < count; ++i) free_unit(fresh[i]);
+        free(fresh);
+        return 0;
+    }
+    free(fresh);
+    session->length = session->length - removed + inserted;
+    session->reparsed_units = count;
+
+    size_t resolved = resolve_units(session, first, first + count);
+    if (resolved == (size_t)-1) return 0;
+    session->reparsed_units += resolved;
+    return 1;
+}
+
+IncrementalSession* incremental_open(const char* source, size_t length) {
+    IncrementalSession* session = calloc(1, sizeof(IncrementalSession));
+    if (!session) return NULL;
+    if (!incremental_edit(session, 0, 0, source, length)) {
+        free_incremental_session(session);
+        return NULL;
+    }
+    return session;
+}
+
+static size_t common_prefix(const char* a, const char* b, size_t n) {
+    size_t i = 0;
+    while (i + 256 <= n && memcmp(a + i, b + i, 256) == 0) i += 256;
+    while (i < n && a[i] == b[i]) i++;
+    return i;
+}
+
+// `a` and `b` point one past the ends of the texts compared
+static size_t common_suffix(const char* a, const char* b, size_t n) {
+    size_t i = 0;
+    while (i + 256 <= n && memcmp(a - i - 256, b - i - 256, 256) == 0) i += 256;
+    while (i < n && a[-1 - (ptrdiff_t)i] == b[-1 - (ptrdiff_t)i]) i++;
+    return i;
+}
+
+int incremental_update(IncrementalSession* session, const char* source, size_t length) {
+    size_t prefix = 0;
+    for (size_t i = 0; i < session->count && prefix < length; ++i) {
+        const IncrementalUnit* unit = session->units[i];
+        size_t n = unit->length < length - prefix ? unit->length : length - prefix;
+        size_t same = common_prefix(unit->text, source + prefix, n);
+        prefix += same;
+        if (same < unit->length) break;
+    }
+    // The suffix may not overlap the prefix in either text
+    size_t limit = (session->length < length ? session->length : length) - prefix;
+    size_t suffix = 0;
+    for (size_t i = session->count; i-- > 0 && suffix < limit;) {
+        const IncrementalUnit* unit = session->units[i];
+        size_t n = unit->length < limit - suffix ? unit->length : limit - suffix;
+        size_t same = common_suffix(unit->text + unit->length, source + length - suffix, n);
+        suffix += same;
+        if (same < unit->length) break;
+    }
+    if (prefix == session->length && prefix == length) {
+        session->relexed_bytes = 0;
+        session->reparsed_units = 0;
+        return 1;
+    }
+    return incremental_edit(session, prefix, session->length - prefix - suffix, source + prefix,
+                            length - prefix - suffix);
+}
+
+int incremental_check(const IncrementalSession* session, IncrementalDiagnostic* out) {
+    // A function name may only be defined once; atoms index the seen flags
+    unsigned char* defined = calloc((size_t)atom_count() + 1, 1);
+    int found = 0;
+    size_t start = 0;
+    for (size_t i = 0; i < session->count && !found; start += session->units[i++]->length) {
+        const IncrementalUnit* unit = session->units[i];
+        found = 1;
+        if (!unit->function) {
+            out->type = ERROR_SYNTAX;
+            out->offset = start + unit->tokens->offsets[0];
+            snprintf(out->message, sizeof(out->message), "Parsing failed");
+        } else if (defined && defined[unit->function->function.name]) {
+            out->type = ERROR_REDEFINITION;
+            out->offset = start + unit->function->loc.offset;
+            snprintf(out->message, sizeof(out->message), "Redefinition of function '%s'",
+                     atom_name(unit->function->function.name));
+        } else if (unit->sema.errors) {
+            out->type = unit->sema.first_type;
+            out->offset = unit->sema.first_offset == SOURCE_OFFSET_NONE ? SOURCE_OFFSET_NONE
+                                                                       : start + unit->sema.first_offset;
+            snprintf(out->message, sizeof(out->message), "%s", unit->sema.first_message);
+        } else {
+            found = 0;
+            if (defined) defined[unit->function->function.name] = 1;
+        }
+    }
+    free(defined);
+    return found;
+}
+
+void incremental_position(const IncrementalSession* session, size_t offset, size_t* line, size_t* column) {
+    *line = 0;
+    *column = 0;
+    if (offset == SOURCE_OFFSET_NONE || session->count == 0) return;
+    size_t i = 0, start = 0, newlines = 0;
+    while (i + 1 < session->count && offset >= start + session->units[i]->length) {
+        newlines += session->units[i]->newlines;
+        start += session->units[i++]->length;
+    }
+    const IncrementalUnit* unit = session->units[i];
+    size_t at = offset - start < unit->length ? offset - start : unit->length;
+    size_t line_start = 0;  // in the unit, valid if the line starts in it
+    int found = 0;
+    for (size_t k = 0; k < at; ++k) {
+        if (unit->text[k] == '\n') {
+            newlines++;
+            line_start = k + 1;
+            found = 1;
+        }
+    }
+    *line = newlines + 1;
+    *column = at - line_start + 1;
+    // Otherwise the line began in an earlier unit
+    while (!found && i-- > 0) {
+        const IncrementalUnit* prev = session->units[i];
+        size_t k = prev->length;
+        while (k > 0 && prev->text[k - 1] != '\n') k--;
+        *column += prev->length - k;
+        found = k > 0;
+    }
+}
+
+int incremental_write_assembly(const IncrementalSession* session, FILE* output) {
+    generate_program_header(output);
+    for (size_t i = 0; i < session->count; ++i) {
+        fwrite(session->units[i]->assembly, 1, session->units[i]->assembly_length, output);
+    }
+    return 1;
+}
+
+void free_incremental_session(IncrementalSession* session) {
+    if (session) {
+        for (size_t i = 0; i < session->count; ++i) free_unit(session->units[i]);
+        free(session->units);
+        free(session);
+    }
+}
@@ -0,0 +1,85 @@
+#ifndef INCREMENTAL_H
+#define INCREMENTAL_H
+
+#include <stddef.h>
+#include <stdio.h>
+#include "../lexer/token_buffer.h"
+#include "../parser/ast.h"
+#include "../semantic/semantic_analyzer.h"
+#include "../utils/arena.h"
+#include "../utils/error_handler.h"
+#include "../utils/symbol_table.h"
+
+// Incremental compilation for edit-compile loops. The source is kept as a
+// sequence of units, one per top-level definition together with the
+// whitespace around it, which partition the file. Each unit owns its text,
+// its token stream and its AST, with offsets relative to the unit, along
+// with its semantic result and its assembly.
+//
+// An edit re-lexes and re-parses only the units it touches (a unit before
+// the edit as well when the edit sits on the boundary), splitting the new
+// text into definitions by brace matching. Every other unit is kept as is,
+// so the work done depends on the size of the edited definitions, not on
+// the size of the file.
+//
+// Like a full parse, a unit may use a name declared by an earlier one (the
+// semantic check then reports it). A unit that fails to parse on its own is
+// parsed again with the names declared before it, whenever an edit touches
+// it or an earlier unit, so it reports what a full build would.
+typedef struct IncrementalUnit {
+    char* text;
+    size_t length;
+    size_t newlines;
+    TokenBuffer* tokens;    // lexed from `text`
+    Arena* arena;           // owns `function`
+    ASTNode* function;      // NULL if the text is not exactly one definition
+    SymbolTable* names;     // variables the definition declares
+    int needs_names;        // does not parse without the names declared before it
+    SemanticResult sema;
+    char* assembly;
+    size_t assembly_length;
+} IncrementalUnit;
+
+typedef struct IncrementalSession {
+    IncrementalUnit** units;
+    size_t count;
+    size_t capacity;
+    size_t length;           // bytes in the whole source
+    // Work done by the last open, edit or update
+    size_t relexed_bytes;
+    size_t reparsed_units;
+} IncrementalSession;
+
+// First problem of the program, as the full compiler would report it
+typedef struct IncrementalDiagnostic {
+    ErrorType type;
+    size_t offset;  // in the whole source
+    char message[256];
+} IncrementalDiagnostic;
+
+// Compiles `source` from scratch. Returns NULL if out of memory; a source
+// that does not parse still yields a session, which reports the failure.
+IncrementalSession* incremental_open(const char* source, size_t length);
+
+// Replaces `removed` bytes at `offset` with `inserted` bytes of `text` and
+// recompiles the definitions involved. Returns 0 on a bad range, leaving the
+// session unchanged, or when out of memory.
+int incremental_edit(IncrementalSession* session, size_t offset, size_t removed, const char* text, size_t inserted);
+
+// Finds the edited byte range between the session's source and `source`
+// (the common prefix and suffix) and applies it as one edit.
+int incremental_update(IncrementalSession* session, const char* source, size_t length);
+
+// Returns 1 and fills `out` if the program has an error
+int incremental_check(const IncrementalSession* session, IncrementalDiagnostic* out);
+
+// 1-based line and column of a source offset
+void incremental_position(const IncrementalSession* session, size_t offset, size_t* line, size_t* column);
+
+// Writes the same assembly as a full compile; the program must check clean.
+// Returns 0 if out of memory.
+int incremental_write_assembly(const IncrementalSession* session, FILE* output);
+
+void free_incremental_session(IncrementalSession* session);
+
+#endif // INCREMENTAL_H
@@ -1,246 +1,325 @@
 #include "ir_generator.h"
 #include "../parser/ast.h"
-#include "../utils/symbol_table.h"
+#include "../semantic/semantic_analyzer.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-// Simple IR instruction types
+// An operand while it is being generated; stored split into kind and value
+typedef struct IROperand {
+    IROperandKind kind;
+    uint32_t value;
+} IROperand;
+
+static const IROperand no_operand = { IR_OPERAND_NONE, 0 };
+static IROperand temp_operand(uint32_t temp) { return (IROperand){ IR_OPERAND_TEMP, temp }; }
+static IROperand block_operand(uint32_t block) { return (IROperand){ IR_OPERAND_BLOCK, block }; }
+// Variable operand of an identifier, declaration or assignment
+static IROperand var_operand(const AstPool* pool, AstRef ref) {
+    return (IROperand){ IR_OPERAND_VAR, ast_pool_slot(pool, ref) };
+}
+
+// Work item of the walk's explicit stack. Nodes expand into the items for
+// their parts, pushed last-first, so nesting depth costs heap, not C stack.
 typedef enum {
-    IR_ASSIGN,
-    IR_ADD,
-    IR_SUB,
-    IR_MUL,
-    IR_DIV,
-    IR_LT,
-    IR_GT,
-    IR_LE,
-    IR_GE,
-    IR_EQ,
-    IR_NEQ,
-    IR_LOAD_CONST,
-    IR_LOAD_VAR,
-    IR_LABEL,
-    IR_JUMP,
-    IR_JUMP_IF_FALSE
-} IRType;
-
-// IR instruction struct
-typedef struct IRInstruction {
-    IRType type;
-    char dest[32];
-    char src1[32];
-    char src2[32];
-    int value; // for constants
-    char label[32]; // for labels
-    struct IRInstruction* next;
-} IRInstruction;
-
-static int temp_count = 0;
-static int label_count = 0;
-static void new_temp(char* buf) { sprintf(buf, "t%d", temp_count++); }
-static void new_label(char* buf) { sprintf(buf, "L%d", label_count++); }
-
-// Forward declaration
-static IRInstruction* generate_ir_node(ASTNode* node, char* result);
+    IR_VISIT,        // generate `node`; an expression leaves its temp in `last`
+    IR_SAVE_LEFT,    // left operand done: keep its temp for the binop
+    IR_EMIT_BINOP,
+    IR_EMIT_ASSIGN,
+    IR_EMIT_RETURN,
+    IR_EMIT_BRANCH,  // ifnot last goto label_a
+    IR_EMIT_ELSE,    // goto label_b; label_a:
+    IR_EMIT_LOOP,    // goto label_a; label_b:
+    IR_EMIT_LABEL    // label_a:
+} IRAction;
+
+typedef struct IRTask {
+    AstRef node;
+    IRAction action;
+    uint32_t label_a;
+    uint32_t label_b;
+} IRTask;
+
+typedef struct IRWalk {
+    const AstPool* pool;
+    IRTask* tasks;
+    size_t task_count;
+    size_t task_capacity;
+    uint32_t* temps;        // saved left operands
+    size_t temp_count;
+    size_t temp_capacity;
+    uint32_t last;          // temp of the last expression generated
+    IRProgram* program;     // appended to in step with the walk
+} IRWalk;
+
+static int push_task(IRWalk* walk, IRAction action, AstRef node, uint32_t label_a, uint32_t label_b) {
+    if (action == IR_VISIT && !node) return 1;
+    if (walk->task_count == walk->task_capacity) {
+        size_t capacity = walk->task_capacity ? walk->task_capacity * 2 : 256;
+        IRTask* grown = realloc(walk->tasks, capacity * sizeof(IRTask));
+        if (!grown) return 0;
+        walk->tasks = grown;
+        walk->task_capacity = capacity;
+    }
+    IRTask* task = &walk->tasks[walk->task_count++];
+    task->node = node;
+    task->action = action;
+    task->label_a = label_a;
+    task->label_b = label_b;
+    return 1;
+}
+
+static int append_ir(IRWalk* walk, IRType type, IROperand a, IROperand b, IROperand c) {
+    IRProgram* program = walk->program;
+    if (program->count == program->capacity) {
+        size_t capacity = program->capacity ? program->capacity * 2 : 256;
+        IRInstruction* grown = realloc(program->code, capacity * sizeof(IRInstruction));
+        if (!grown) return 0;
+        program->code = grown;
+        program->capacity = capacity;
+    }
+    IRInstruction* instr = &program->code[program->count++];
+    instr->type = (uint8_t)type;
+    instr->kinds[0] = (uint8_t)a.kind;
+    instr->kinds[1] = (uint8_t)b.kind;
+    instr->kinds[2] = (uint8_t)c.kind;
+    instr->operands[0] = a.value;
+    instr->operands[1] = b.value;
+    instr->operands[2] = c.value;
+    return 1;
+}
+
+// Result of an expression: a new virtual register, which becomes `last`
+static IROperand new_temp(IRWalk* walk) {
+    walk->last = walk->program->temp_count++;
+    return temp_operand(walk->last);
+}
+
+static int append_label(IRWalk* walk, IRType type, uint32_t label) {
+    return append_ir(walk, type, block_operand(label), no_operand, no_operand);
+}
 
-// Main IR generation entry point
 void generate_ir(ASTNode* node, FILE* output) {
-    char result[32];
-    temp_count = 0;
-    label_count = 0;
-    IRInstruction* ir = generate_ir_node(node, result);
-    // Print IR
+    AstPool* pool = ast_pool_build(node);
+    if (!pool) {
+        fprintf(stderr, "[ERROR] generate_ir: out of memory building the AST pool\n");
+        return;
+    }
+    analyze_semantics_pool(pool, 1);
+    generate_ir_pool(pool, pool->root, output);
+    free_ast_pool(pool);
+}
+
+// Main IR generation entry point
+void generate_ir_pool(const AstPool* pool, AstRef node, FILE* output) {
+    IRProgram program = {0};
+    if (!generate_ir_program(pool, node, &program)) {
+        fprintf(stderr, "[ERROR] Out of memory while generating IR\n");
+    }
+    print_ir_program(&program, output);
+    free_ir_program(&program);
+}
+
+static void print_operand(FILE* output, const IRInstruction* instr, unsigned i) {
+    uint32_t value = instr->operands[i];
+    switch ((IROperandKind)instr->kinds[i]) {
+        case IR_OPERAND_TEMP: fprintf(output, "t%u", value); break;
+        case IR_OPERAND_VAR: fprintf(output, "v%u", value); break;
+        case IR_OPERAND_IMM: fprintf(output, "%d", (int)value); break;
+        case IR_OPERAND_BLOCK: fprintf(output, "L%u", value); break;
+        case IR_OPERAND_NONE: break;
+    }
+}
+
+void print_ir_program(const IRProgram* program, FILE* output) {
+    static const char* binop_symbols[] = {
+        [IR_ADD] = "+", [IR_SUB] = "-", [IR_MUL] = "*", [IR_DIV] = "/", [IR_LT] = "<",
+        [IR_GT] = ">", [IR_LE] = "<=", [IR_GE] = ">=", [IR_EQ] = "==", [IR_NEQ] = "!=",
+    };
     fprintf(output, "[IR] Generated IR instructions:\n");
-    for (IRInstruction* instr = ir; instr; instr = instr->next) {
-        switch (instr->type) {
+    for (size_t i = 0; i < program->count; ++i) {
+        const IRInstruction* instr = &program->code[i];
+        switch ((IRType)instr->type) {
             case IR_ASSIGN:
-                fprintf(output, "%s = %s\n", instr->dest, instr->src1);
+            case IR_LOAD_CONST:
+            case IR_LOAD_VAR:
+                print_operand(output, instr, 0);
+                fprintf(output, " = ");
+                print_operand(output, instr, 1);
                 break;
             case IR_ADD:
-                fprintf(output, "%s = %s + %s\n", instr->dest, instr->src1, instr->src2);
-                break;
             case IR_SUB:
-                fprintf(output, "%s = %s - %s\n", instr->dest, instr->src1, instr->src2);
-                break;
             case IR_MUL:
-                fprintf(output, "%s = %s * %s\n", instr->dest, instr->src1, instr->src2);
-                break;
             case IR_DIV:
-                fprintf(output, "%s = %s / %s\n", instr->dest, instr->src1, instr->src2);
-                break;
             case IR_LT:
-                fprintf(output, "%s = %s < %s\n", instr->dest, instr->src1, instr->src2);
-                break;
             case IR_GT:
-                fprintf(output, "%s = %s > %s\n", instr->dest, instr->src1, instr->src2);
-                break;
             case IR_LE:
-                fprintf(output, "%s = %s <= %s\n", instr->dest, instr->src1, instr->src2);
-                break;
             case IR_GE:
-                fprintf(output, "%s = %s >= %s\n", instr->dest, instr->src1, instr->src2);
-                break;
             case IR_EQ:
-                fprintf(output, "%s = %s == %s\n", instr->dest, instr->src1, instr->src2);
-                break;
             case IR_NEQ:
-                fprintf(output, "%s = %s != %s\n", instr->dest, instr->src1, instr->src2);
-                break;
-            case IR_LOAD_CONST:
-                fprintf(output, "%s = %d\n", instr->dest, instr->value);
-                break;
-            case IR_LOAD_VAR:
-                fprintf(output, "%s = %s\n", instr->dest, instr->src1);
+                print_operand(output, instr, 0);
+                fprintf(output, " = ");
+                print_operand(output, instr, 1);
+                fprintf(output, " %s ", binop_symbols[instr->type]);
+                print_operand(output, instr, 2);
                 break;
             case IR_LABEL:
-                fprintf(output, "%s:\n", instr->label);
+                print_operand(output, instr, 0);
+                fprintf(output, ":");
                 break;
             case IR_JUMP:
-                fprintf(output, "goto %s\n", instr->label);
+                fprintf(output, "goto ");
+                print_operand(output, instr, 0);
                 break;
             case IR_JUMP_IF_FALSE:
-                fprintf(output, "ifnot %s goto %s\n", instr->src1, instr->label);
+                fprintf(output, "ifnot ");
+                print_operand(output, instr, 1);
+                fprintf(output, " goto ");
+                print_operand(output, instr, 0);
+                break;
+            case IR_RETURN:
+                fprintf(output, "return ");
+                print_operand(output, instr, 1);
                 break;
         }
-    }
-    // Free IR list
-    while (ir) {
-        IRInstruction* next = ir->next;
-        free(ir);
-        ir = next;
+        fprintf(output, "\n");
     }
 }
 
-static IRInstruction* append_ir(IRInstruction* head, IRInstruction* tail) {
-    if (!head) return tail;
-    IRInstruction* cur = head;
-    while (cur->next) cur = cur->next;
-    cur->next = tail;
-    return head;
+void free_ir_program(IRProgram* program) {
+    free(program->code);
+    program->code = NULL;
+    program->count = 0;
+    program->capacity = 0;
+    program->temp_count = 0;
+    program->block_count = 0;
 }
 
-static IRInstruction* generate_ir_node(ASTNode* node, char* result) {
-    if (!node) return NULL;
-    switch (node->type) {
+static IRType binop_ir_type(BinOpType op) {
+    switch (op) {
+        case OP_ADD: return IR_ADD;
+        case OP_SUB: return IR_SUB;
+        case OP_MUL: return IR_MUL;
+        case OP_DIV: return IR_DIV;
+        case OP_LT: return IR_LT;
+        case OP_GT: return IR_GT;
+        case OP_LE: return IR_LE;
+        case OP_GE: return IR_GE;
+        case OP_EQ: return IR_EQ;
+        case OP_NEQ: return IR_NEQ;
+        default: return IR_ADD;
+    }
+}
+
+// Emits what a node produces before its parts and queues the parts
+static int expand_node(IRWalk* walk, AstRef node) {
+    const AstPool* pool = walk->pool;
+    switch (ast_pool_kind(pool, node)) {
         case AST_NUMBER: {
-            new_temp(result);
-            IRInstruction* instr = calloc(1, sizeof(IRInstruction));
-            instr->type = IR_LOAD_CONST;
-            strcpy(instr->dest, result);
-            instr->value = node->value;
-            return instr;
-        }
-        case AST_IDENTIFIER: {
-            new_temp(result);
-            IRInstruction* instr = calloc(1, sizeof(IRInstruction));
-            instr->type = IR_LOAD_VAR;
-            strcpy(instr->dest, result);
-            strcpy(instr->src1, node->identifier);
-            return instr;
+            IROperand value = { IR_OPERAND_IMM, ast_pool_field(pool, node, 0) };
+            return append_ir(walk, IR_LOAD_CONST, new_temp(walk), value, no_operand);
         }
-        case AST_BINARY_OP: {
-            char left[32], right[32];
-            IRInstruction* left_ir = generate_ir_node(node->binop.left, left);
-            IRInstruction* right_ir = generate_ir_node(node->binop.right, right);
-            new_temp(result);
-            IRInstruction* instr = calloc(1, sizeof(IRInstruction));
-            switch (node->binop.op_type) {
-                case OP_ADD: instr->type = IR_ADD; break;
-                case OP_SUB: instr->type = IR_SUB; break;
-                case OP_MUL: instr->type = IR_MUL; break;
-                case OP_DIV: instr->type = IR_DIV; break;
-                case OP_LT: instr->type = IR_LT; break;
-                case OP_GT: instr->type = IR_GT; break;
-                case OP_LE: instr->type = IR_LE; break;
-                case OP_GE: instr->type = IR_GE; break;
-                case OP_EQ: instr->type = IR_EQ; break;
-                case OP_NEQ: instr->type = IR_NEQ; break;
-                default: instr->type = IR_ADD; break;
+        case AST_IDENTIFIER:
+            return append_ir(walk, IR_LOAD_VAR, new_temp(walk), var_operand(pool, node), no_operand);
+        case AST_BINARY_OP:
+            return push_task(walk, IR_EMIT_BINOP, node, 0, 0) &&
+                   push_task(walk, IR_VISIT, ast_pool_field(pool, node, 1), 0, 0) &&
+                   push_task(walk, IR_SAVE_LEFT, node, 0, 0) &&
+                   push_task(walk, IR_VISIT, ast_pool_field(pool, node, 0), 0, 0);
+        case AST_DECLARATION:
+            // An initializer is an assignment to the new slot; without one it starts at 0
+            if (!ast_pool_field(pool, node, 1)) {
+                IROperand zero = { IR_OPERAND_IMM, 0 };
+                return append_ir(walk, IR_ASSIGN, var_operand(pool, node), zero, no_operand);
             }
-            strcpy(instr->dest, result);
-            strcpy(instr->src1, left);
-            strcpy(instr->src2, right);
-            return append_ir(append_ir(left_ir, right_ir), instr);
-        }
-        case AST_ASSIGNMENT: {
-            char rhs[32];
-            IRInstruction* rhs_ir = generate_ir_node(node->assignment.value, rhs);
-            IRInstruction* instr = calloc(1, sizeof(IRInstruction));
-            instr->type = IR_ASSIGN;
-            strcpy(instr->dest, node->assignment.name);
-            strcpy(instr->src1, rhs);
-            return append_ir(rhs_ir, instr);
-        }
-        case AST_COMPOUND: {
-            IRInstruction* head = NULL;
-            for (size_t i = 0; i < node->compound.count; ++i) {
-                char dummy[32];
-                IRInstruction* stmt_ir = generate_ir_node(node->compound.statements[i], dummy);
-                head = append_ir(head, stmt_ir);
+            return push_task(walk, IR_EMIT_ASSIGN, node, 0, 0) &&
+                   push_task(walk, IR_VISIT, ast_pool_field(pool, node, 1), 0, 0);
+        case AST_ASSIGNMENT:
+            return push_task(walk, IR_EMIT_ASSIGN, node, 0, 0) &&
+                   push_task(walk, IR_VISIT, ast_pool_field(pool, node, 1), 0, 0);
+        case AST_RETURN:
+            return push_task(walk, IR_EMIT_RETURN, node, 0, 0) &&
+                   push_task(walk, IR_VISIT, ast_pool_field(pool, node, 0), 0, 0);
+        case AST_BLOCK:
+        case AST_COMPOUND:
+            for (size_t i = ast_pool_field(pool, node, 0); i-- > 0;) {
+                if (!push_task(walk, IR_VISIT, ast_pool_statement(pool, node, i), 0, 0)) return 0;
             }
-            return head;
-        }
+            return 1;
         case AST_IF: {
-            char cond[32], label_else[32], label_end[32];
-            IRInstruction* cond_ir = generate_ir_node(node->if_stmt.condition, cond);
-            new_label(label_else);
-            new_label(label_end);
-            IRInstruction* jump_if_false = calloc(1, sizeof(IRInstruction));
-            jump_if_false->type = IR_JUMP_IF_FALSE;
-            strcpy(jump_if_false->src1, cond);
-            strcpy(jump_if_false->label, label_else);
-            IRInstruction* then_ir = generate_ir_node(node->if_stmt.then_branch, NULL);
-            IRInstruction* jump_end = calloc(1, sizeof(IRInstruction));
-            jump_end->type = IR_JUMP;
-            strcpy(jump_end->label, label_end);
-            IRInstruction* else_label = calloc(1, sizeof(IRInstruction));
-            else_label->type = IR_LABEL;
-            strcpy(else_label->label, label_else);
-            IRInstruction* else_ir = NULL;
-            if (node->if_stmt.else_branch) {
-                else_ir = generate_ir_node(node->if_stmt.else_branch, NULL);
-            }
-            IRInstruction* end_label = calloc(1, sizeof(IRInstruction));
-            end_label->type = IR_LABEL;
-            strcpy(end_label->label, label_end);
-            // Chain: cond_ir -> jump_if_false -> then_ir -> jump_end -> else_label -> else_ir -> end_label
-            IRInstruction* head = append_ir(cond_ir, jump_if_false);
-            head = append_ir(head, then_ir);
-            head = append_ir(head, jump_end);
-            head = append_ir(head, else_label);
-            head = append_ir(head, else_ir);
-            head = append_ir(head, end_label);
-            return head;
+            // Chain: cond -> ifnot goto else -> then -> goto end -> else: -> else -> end:
+            // Labels are numbered after the condition, which never takes any
+            uint32_t label_else = walk->program->block_count++;
+            uint32_t label_end = walk->program->block_count++;
+            return push_task(walk, IR_EMIT_LABEL, node, label_end, 0) &&
+                   push_task(walk, IR_VISIT, ast_pool_field(pool, node, 2), 0, 0) &&
+                   push_task(walk, IR_EMIT_ELSE, node, label_else, label_end) &&
+                   push_task(walk, IR_VISIT, ast_pool_field(pool, node, 1), 0, 0) &&
+                   push_task(walk, IR_EMIT_BRANCH, node, label_else, 0) &&
+                   push_task(walk, IR_VISIT, ast_pool_field(pool, node, 0), 0, 0);
         }
         case AST_WHILE: {
-            char cond[32], label_start[32], label_end[32];
-            new_label(label_start);
-            new_label(label_end);
-            IRInstruction* start_label = calloc(1, sizeof(IRInstruction));
-            start_label->type = IR_LABEL;
-            strcpy(start_label->label, label_start);
-            IRInstruction* cond_ir = generate_ir_node(node->while_stmt.condition, cond);
-            IRInstruction* jump_if_false = calloc(1, sizeof(IRInstruction));
-            jump_if_false->type = IR_JUMP_IF_FALSE;
-            strcpy(jump_if_false->src1, cond);
-            strcpy(jump_if_false->label, label_end);
-            IRInstruction* body_ir = generate_ir_node(node->while_stmt.body, NULL);
-            IRInstruction* jump_start = calloc(1, sizeof(IRInstruction));
-            jump_start->type = IR_JUMP;
-            strcpy(jump_start->label, label_start);
-            IRInstruction* end_label = calloc(1, sizeof(IRInstruction));
-            end_label->type = IR_LABEL;
-            strcpy(end_label->label, label_end);
-            // Chain: start_label -> cond_ir -> jump_if_false -> body_ir -> jump_start -> end_label
-            IRInstruction* head = append_ir(start_label, cond_ir);
-            head = append_ir(head, jump_if_false);
-            head = append_ir(head, body_ir);
-            head = append_ir(head, jump_start);
-            head = append_ir(head, end_label);
-            return head;
+            // Chain: start: -> cond -> ifnot goto end -> body -> goto start -> end:
+            uint32_t label_start = walk->program->block_count++;
+            uint32_t label_end = walk->program->block_count++;
+            return append_label(walk, IR_LABEL, label_start) &&
+                   push_task(walk, IR_EMIT_LOOP, node, label_start, label_end) &&
+                   push_task(walk, IR_VISIT, ast_pool_field(pool, node, 1), 0, 0) &&
+                   push_task(walk, IR_EMIT_BRANCH, node, label_end, 0) &&
+                   push_task(walk, IR_VISIT, ast_pool_field(pool, node, 0), 0, 0);
         }
         default:
-            return NULL;
+            return 1;
+    }
+}
+
+static int run_task(IRWalk* walk, IRTask task) {
+    switch (task.action) {
+        case IR_VISIT:
+            return expand_node(walk, task.node);
+        case IR_SAVE_LEFT:
+            if (walk->temp_count == walk->temp_capacity) {
+                size_t capacity = walk->temp_capacity ? walk->temp_capacity * 2 : 64;
+                uint32_t* grown = realloc(walk->temps, capacity * sizeof(uint32_t));
+                if (!grown) return 0;
+                walk->temps = grown;
+                walk->temp_capacity = capacity;
+            }
+            walk->temps[walk->temp_count++] = walk->last;
+            return 1;
+        case IR_EMIT_BINOP: {
+            IROperand left = temp_operand(walk->temps[--walk->temp_count]);
+            IROperand right = temp_operand(walk->last);
+            return append_ir(walk, binop_ir_type(ast_pool_op(walk->pool, task.node)), new_temp(walk), left, right);
+        }
+        case IR_EMIT_ASSIGN:
+            return append_ir(walk, IR_ASSIGN, var_operand(walk->pool, task.node), temp_operand(walk->last),
+                             no_operand);
+        case IR_EMIT_RETURN:
+            return append_ir(walk, IR_RETURN, no_operand, temp_operand(walk->last), no_operand);
+        case IR_EMIT_BRANCH:
+            return append_ir(walk, IR_JUMP_IF_FALSE, block_operand(task.label_a), temp_operand(walk->last),
+                             no_operand);
+        case IR_EMIT_ELSE:
+            return append_label(walk, IR_JUMP, task.label_b) && append_label(walk, IR_LABEL, task.label_a);
+        case IR_EMIT_LOOP:
+            return append_label(walk, IR_JUMP, task.label_a) && append_label(walk, IR_LABEL, task.label_b);
+        case IR_EMIT_LABEL:
+            return append_label(walk, IR_LABEL, task.label_a);
+    }
+    return 1;
+}
+
+// Generates IR for a tree in program order, driven by an explicit stack
+int generate_ir_program(const AstPool* pool, AstRef node, IRProgram* program) {
+    IRWalk walk = {0};
+    walk.pool = pool;
+    walk.program = program;
+    int ok = push_task(&walk, IR_VISIT, node, 0, 0);
+    while (ok && walk.task_count > 0) {
+        ok = run_task(&walk, walk.tasks[--walk.task_count]);
     }
+    free(walk.tasks);
+    free(walk.temps);
+    return ok;
 }
@@ -5,10 +5,92 @@
 extern "C" {
 #endif
 
-#include "../parser/ast.h"   // Use ast.h because generate_ir works on ASTNode*
+#include "../parser/ast.h"
+#include "../parser/ast_pool.h"
+#include <stdint.h>
 #include <stdio.h>
 
-void generate_ir(ASTNode* node, FILE* output);
+// Three-address IR instruction types
+typedef enum {
+    IR_ASSIGN,
+    IR_ADD,
+    IR_SUB,
+    IR_MUL,
+    IR_DIV,
+    IR_LT,
+    IR_GT,
+    IR_LE,
+    IR_GE,
+    IR_EQ,
+    IR_NEQ,
+    IR_LOAD_CONST,
+    IR_LOAD_VAR,
+    IR_LABEL,
+    IR_JUMP,
+    IR_JUMP_IF_FALSE,
+    IR_RETURN
+} IRType;
+
+// What an operand's 32-bit value means
+typedef enum {
+    IR_OPERAND_NONE,
+    IR_OPERAND_TEMP,   // virtual register, numbered per program
+    IR_OPERAND_VAR,    // variable, by the frame slot semantic analysis bound it to
+    IR_OPERAND_IMM,    // constant, the full int
+    IR_OPERAND_BLOCK   // label
+} IROperandKind;
+
+// One 16-byte instruction: the opcode and the kind of each operand, then
+// the operands. Per type:
+//
+//   IR_ASSIGN          var = temp               (var = 0 for a declaration)
+//   IR_ADD ... IR_NEQ  temp = temp op temp
+//   IR_LOAD_CONST      temp = imm
+//   IR_LOAD_VAR        temp = var
+//   IR_LABEL           block:
+//   IR_JUMP            goto block
+//   IR_JUMP_IF_FALSE   ifnot temp goto block    (operands: block, temp)
+//   IR_RETURN          return temp              (operands: none, temp)
+//
+// as generated; optimize_ir may replace a source temp with the immediate or
+// variable it was loaded from. Comparing two operands is comparing their
+// kinds and values.
+//
+// Temps come from expression trees, so each is used once, and the temp an
+// instruction uses is always the one defined last among those not yet used:
+// live temps form a stack. The optimizer keeps that shape and the x86-64
+// lowering relies on it.
+#define IR_MAX_OPERANDS 3
+
+typedef struct IRInstruction {
+    uint8_t type;                        // IRType
+    uint8_t kinds[IR_MAX_OPERANDS];      // IROperandKind
+    uint32_t operands[IR_MAX_OPERANDS];  // dest (or target) first, then sources
+} IRInstruction;
+
+// Instructions in program order, in one block that doubles as it fills:
+// appending is amortized O(1), with no allocation per instruction, and the
+// whole program is released with one free.
+typedef struct IRProgram {
+    IRInstruction* code;
+    size_t count;
+    size_t capacity;
+    uint32_t temp_count;   // virtual registers used: t0 .. t<temp_count-1>
+    uint32_t block_count;  // labels used
+} IRProgram;
+
+// Generates IR for `node` into `program`, which starts zeroed. Returns 0 if
+// out of memory (the instructions generated so far are kept).
+int generate_ir_program(const AstPool* pool, AstRef node, IRProgram* program);
+// Debug dump of the instructions as text, one per line
+void print_ir_program(const IRProgram* program, FILE* output);
+void free_ir_program(IRProgram* program);
+
+// Debug dump: prints three-address IR for `node`. Variables are named by
+// the frame slot semantic analysis bound them to (v0, v1, ...), so the pool
+// must have been checked first.
+void generate_ir_pool(const AstPool* pool, AstRef node, FILE* output);
+void generate_ir(ASTNode* node, FILE* output);  // copies the tree into an AstPool and checks it first
 
 #ifdef __cplusplus
 }
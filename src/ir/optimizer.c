@@ -1,6 +1,93 @@
 // optimizer.c
 #include "optimizer.h"
+#include <stdint.h>
+#include <stdlib.h>
 
-void optimize_ir(ASTNode* node) {
-    // Simple stub: no optimization yet
+// Result of a binary operation on two constants, as the generated code
+// computes it in 64 bits; 0 if it does not fold to an int (or divides by 0)
+static int fold_binop(IRType type, int64_t left, int64_t right, int32_t* result) {
+    int64_t value;
+    switch (type) {
+        case IR_ADD: value = left + right; break;
+        case IR_SUB: value = left - right; break;
+        case IR_MUL: value = left * right; break;
+        case IR_DIV:
+            if (right == 0) return 0;
+            value = left / right;
+            break;
+        case IR_LT: value = left < right; break;
+        case IR_GT: value = left > right; break;
+        case IR_LE: value = left <= right; break;
+        case IR_GE: value = left >= right; break;
+        case IR_EQ: value = left == right; break;
+        case IR_NEQ: value = left != right; break;
+        default: return 0;
+    }
+    if (value < INT32_MIN || value > INT32_MAX) return 0;
+    *result = (int32_t)value;
+    return 1;
+}
+
+void optimize_ir(IRProgram* program) {
+    // What each temp is known to hold: an immediate, a variable, or nothing
+    // known (IR_OPERAND_NONE). Temps are used once, so a forwarded one needs
+    // no other bookkeeping.
+    uint8_t* kinds = calloc(program->temp_count ? program->temp_count : 1, sizeof(uint8_t));
+    uint32_t* values = malloc((program->temp_count ? program->temp_count : 1) * sizeof(uint32_t));
+    if (!kinds || !values) {
+        free(kinds);
+        free(values);
+        return;  // left unoptimized
+    }
+
+    size_t kept = 0;
+    for (size_t i = 0; i < program->count; ++i) {
+        IRInstruction instr = program->code[i];
+        for (unsigned k = 1; k < IR_MAX_OPERANDS; ++k) {
+            if (instr.kinds[k] == IR_OPERAND_TEMP && kinds[instr.operands[k]] != IR_OPERAND_NONE) {
+                instr.kinds[k] = kinds[instr.operands[k]];
+                instr.operands[k] = values[instr.operands[k]];
+            }
+        }
+
+        int32_t folded;
+        switch ((IRType)instr.type) {
+            case IR_LOAD_CONST:
+            case IR_LOAD_VAR:
+                kinds[instr.operands[0]] = instr.kinds[1];
+                values[instr.operands[0]] = instr.operands[1];
+                continue;
+            case IR_ADD:
+            case IR_SUB:
+            case IR_MUL:
+            case IR_DIV:
+            case IR_LT:
+            case IR_GT:
+            case IR_LE:
+            case IR_GE:
+            case IR_EQ:
+            case IR_NEQ:
+                if (instr.kinds[1] == IR_OPERAND_IMM && instr.kinds[2] == IR_OPERAND_IMM &&
+                    fold_binop((IRType)instr.type, (int32_t)instr.operands[1], (int32_t)instr.operands[2], &folded)) {
+                    kinds[instr.operands[0]] = IR_OPERAND_IMM;
+                    values[instr.operands[0]] = (uint32_t)folded;
+                    continue;
+                }
+                break;
+            case IR_JUMP_IF_FALSE:
+                if (instr.kinds[1] == IR_OPERAND_IMM) {
+                    if (instr.operands[1] != 0) continue;
+                    instr.type = IR_JUMP;
+                    instr.kinds[1] = IR_OPERAND_NONE;
+                    instr.operands[1] = 0;
+                }
+                break;
+            default:
+                break;
+        }
+        program->code[kept++] = instr;
+    }
+    program->count = kept;
+    free(kinds);
+    free(values);
 }
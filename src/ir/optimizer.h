@@ -1,8 +1,13 @@
 #ifndef OPTIMIZER_H
 #define OPTIMIZER_H
 
-#include "parser/parser.h"
+#include "ir_generator.h"
 
-void optimize_ir(ASTNode* node);
+// Rewrites one function's IR in place, in a single pass: constants and
+// variables loaded into a temp are forwarded into the instruction that uses
+// the temp, and the load is dropped; binary operations on two constants are
+// folded; branches on a constant become a jump or disappear. The temps keep
+// their stack shape (see ir_generator.h).
+void optimize_ir(IRProgram* program);
 
 #endif
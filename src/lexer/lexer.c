@@ -1,221 +1,351 @@
 #include "lexer.h"
+#include "lexer_scan.h"
+#include "lexer_tables.h"
+#include "../utils/trace.h"
 #include <stdlib.h>
 #include <string.h>
-#include <ctype.h>
 #include <stdio.h>
 
 #ifdef _WIN32
+#include <windows.h>
 #define strdup _strdup
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #endif
 
-#ifndef HAVE_STRNDUP
-char* strndup(const char* s, size_t n) {
-    size_t len = strlen(s);
-    if (len > n) len = n;
-    char* result = (char*)malloc(len + 1);
-    if (!result) return NULL;
-    memcpy(result, s, len);
-    result[len] = '\0';
-    return result;
+void lexer_init_span(Lexer* lexer, const char* input, size_t length) {
+    lexer->input = input;
+    lexer->length = length;
+    lexer->position = 0;
+    line_index_init(&lexer->lines, input, length);
+    lexer->mapping = NULL;
+    lexer->mapping_size = 0;
+    lexer->base = 0;
+    lexer->token_start = 0;
+    lexer->retain = LEXER_RETAIN_NONE;
+    lexer->refill = NULL;
+    lexer->refill_ctx = NULL;
+    lexer->window_capacity = length;
+    lexer->chunk_size = 0;
+    lexer->at_eof = 1;
+    lexer->intern_identifiers = 1;
 }
-#endif
 
-Lexer* create_lexer(const char* input) {
+static Lexer* create_lexer_for_buffer(const char* input, size_t length) {
     Lexer* lexer = malloc(sizeof(Lexer));
-    lexer->input = strdup(input);
-    lexer->position = 0;
-    lexer->line = 1;
-    lexer->column = 1;
+    lexer_init_span(lexer, input, length);
     return lexer;
 }
 
-void advance(Lexer* lexer) {
-    if (lexer->input[lexer->position] == '\n') {
-        lexer->line++;
-        lexer->column = 1;
-    } else {
-        lexer->column++;
+Lexer* create_lexer(const char* input) {
+    return create_lexer_for_buffer(strdup(input), strlen(input));
+}
+
+// Streaming mode: slides the window forward and reads the next chunk.
+// Bytes from the current token (and from `retain`) onward are kept at the
+// front of the window; the window only grows when they fill half of it.
+// Returns 0 once the input is exhausted.
+static int refill_window(Lexer* lexer) {
+    if (!lexer->refill || lexer->at_eof) return 0;
+    char* window = (char*)lexer->input;
+    size_t keep_from = lexer->token_start;
+    if (lexer->retain != LEXER_RETAIN_NONE && lexer->retain >= lexer->base &&
+        lexer->retain - lexer->base < keep_from) {
+        keep_from = lexer->retain - lexer->base;
+    }
+    size_t keep = lexer->length - keep_from;
+    memmove(window, window + keep_from, keep);
+    lexer->base += keep_from;
+    lexer->position -= keep_from;
+    lexer->token_start -= keep_from;
+    lexer->length = keep;
+
+    if (keep > lexer->window_capacity / 2) {
+        lexer->window_capacity *= 2;
+        window = realloc(window, lexer->window_capacity);
+        lexer->input = window;
     }
+    size_t n = lexer->refill(lexer->refill_ctx, window + keep, lexer->window_capacity - keep);
+    if (n == 0) {
+        lexer->at_eof = 1;
+        return 0;
+    }
+    line_index_feed(&lexer->lines, window + keep, n);
+    lexer->length += n;
+    TRACE(TRACE_LEXER, "refill", "base=%zu kept=%zu read=%zu window=%zu",
+          lexer->base, keep, n, lexer->window_capacity);
+    return 1;
+}
+
+// Character at the current position, '\0' once the input is exhausted
+static inline char current_char(Lexer* lexer) {
+    if (lexer->position < lexer->length) return lexer->input[lexer->position];
+    return refill_window(lexer) ? lexer->input[lexer->position] : '\0';
+}
+
+// Callers have just examined the byte through current_char, so it is in the window
+void advance(Lexer* lexer) {
     lexer->position++;
 }
 
 void skip_whitespace(Lexer* lexer) {
-    while (isspace(lexer->input[lexer->position])) {
-        advance(lexer);
+    for (;;) {
+        size_t remaining = lexer->length - lexer->position;
+        size_t n = scan_whitespace(lexer->input + lexer->position, remaining);
+        lexer->position += n;
+        lexer->token_start = lexer->position;  // whitespace never needs to be kept
+        if (n < remaining || !refill_window(lexer)) break;
     }
 }
 
-Token* create_token(TokenType type, const char* value, int line, int column) {
+// Consumes `n` bytes already examined by a scanning kernel
+static inline void advance_run(Lexer* lexer, size_t n) {
+    lexer->position += n;
+}
+
+Token* create_token(TokenType type, const char* text, size_t length, size_t offset) {
     Token* token = malloc(sizeof(Token));
     token->type = type;
-    token->value = strdup(value);
-    token->line = line;
-    token->column = column;
+    token->text = text;
+    token->length = length;
+    token->offset = offset;
+    token->number = 0;
     return token;
 }
 
-TokenType check_keyword(const char* str) {
-    if (strcmp(str, "if") == 0) return TOKEN_IF;
-    if (strcmp(str, "else") == 0) return TOKEN_ELSE;
-    if (strcmp(str, "while") == 0) return TOKEN_WHILE;
-    if (strcmp(str, "return") == 0) return TOKEN_RETURN;
-    if (strcmp(str, "int") == 0) return TOKEN_INT;
+TokenType check_keyword(const char* str, size_t length) {
+    const KeywordSlot* slot = &keyword_slots[KEYWORD_HASH(str[0], str[length - 1], length)];
+    if (slot->length == length && memcmp(str, slot->text, length) == 0) {
+        return (TokenType)slot->type;
+    }
     return TOKEN_IDENTIFIER;
 }
 
-Token* get_next_token(Lexer* lexer) {
-    skip_whitespace(lexer);
-    char current = lexer->input[lexer->position];
-    int line = lexer->line;
-    int col = lexer->column;
+// Fills `out` with the span from token_start up to the current position
+static void span_token(Lexer* lexer, Token* out, TokenType type) {
+    out->type = type;
+    out->text = &lexer->input[lexer->token_start];
+    out->length = lexer->position - lexer->token_start;
+    out->offset = lexer->base + lexer->token_start;
+    out->number = 0;
+}
 
-    // Robust EOF check: if at end, return EOF immediately
-    if (current == '\0') {
-        return create_token(TOKEN_EOF, "", line, col);
-    }
+static inline uint8_t current_class(Lexer* lexer) {
+    return char_class[(unsigned char)current_char(lexer)];
+}
+
+void lexer_scan_token(Lexer* lexer, Token* out) {
+    skip_whitespace(lexer);
 
-    // Skip any non-ASCII or non-printable characters
-    while (current != '\0' && ((unsigned char)current > 127 || (current < 32 && current != '\n' && current != '\t'))) {
+    // Skip any non-ASCII or non-printable characters. Whatever follows is
+    // lexed as-is, so a space or newline right after them is an error token.
+    while (current_class(lexer) == C_SKP) {
         advance(lexer);
-        current = lexer->input[lexer->position];
-    }
-    if (current == '\0') {
-        return create_token(TOKEN_EOF, "", line, col);
+        lexer->token_start = lexer->position;
     }
 
-    // Identifiers and keywords
-    if (isalpha(current) || current == '_') {
-        int start = lexer->position;
-        while (isalnum(lexer->input[lexer->position]) || lexer->input[lexer->position] == '_') {
+    // Run the token DFA. Identifier and number states loop on themselves;
+    // those runs are consumed in one step by the scanning kernels (a run
+    // cut by the end of a streaming window continues on the next iteration).
+    lexer->token_start = lexer->position;
+    uint8_t state = S_START;
+    for (;;) {
+        uint8_t next = dfa_next[state][current_class(lexer)];
+        if (next == S_STOP) break;
+        if (next == S_IDENT) {
+            advance_run(lexer, scan_identifier(lexer->input + lexer->position, lexer->length - lexer->position));
+        } else if (next == S_NUMBER) {
+            advance_run(lexer, scan_digits(lexer->input + lexer->position, lexer->length - lexer->position));
+        } else {
             advance(lexer);
         }
-        int length = lexer->position - start;
-        char* value = strndup(&lexer->input[start], length);
-        TokenType type = check_keyword(value);
-        return create_token(type, value, line, col);
+        state = next;
     }
 
-    // Numbers
-    if (isdigit(current)) {
-        int start = lexer->position;
-        while (isdigit(lexer->input[lexer->position])) {
-            advance(lexer);
+    size_t start = lexer->token_start;
+    if (state == S_IDENT) {
+        TokenType type = check_keyword(&lexer->input[start], lexer->position - start);
+        span_token(lexer, out, type);
+        if (type == TOKEN_IDENTIFIER && lexer->intern_identifiers) {
+            out->atom = intern(out->text, out->length);
+            if (out->atom == ATOM_NONE) {
+                fprintf(stderr, "Error: out of memory while interning identifiers\n");
+                out->type = TOKEN_ERROR;
+            }
         }
-        int length = lexer->position - start;
-        char* value = strndup(&lexer->input[start], length);
-        return create_token(TOKEN_NUMBER, value, line, col);
-    }
-
-    // Operators and punctuation
-    if (current == '=') {
-        advance(lexer);
-        if (lexer->input[lexer->position] == '=') {
-            advance(lexer);
-            return create_token(TOKEN_EQ, "==", line, col);
-        }
-        return create_token(TOKEN_ASSIGN, "=", line, col);
-    }
-    if (current == '!') {
-        advance(lexer);
-        if (lexer->input[lexer->position] == '=') {
-            advance(lexer);
-            return create_token(TOKEN_NEQ, "!=", line, col);
-        }
-        return create_token(TOKEN_ERROR, "!", line, col);
-    }
-    if (current == '>') {
-        advance(lexer);
-        if (lexer->input[lexer->position] == '=') {
-            advance(lexer);
-            return create_token(TOKEN_GE, ">=", line, col);
-        }
-        return create_token(TOKEN_GT, ">", line, col);
-    }
-    if (current == '<') {
-        advance(lexer);
-        if (lexer->input[lexer->position] == '=') {
-            advance(lexer);
-            return create_token(TOKEN_LE, "<=", line, col);
-        }
-        return create_token(TOKEN_LT, "<", line, col);
-    }
-    switch (current) {
-        case '+': advance(lexer); return create_token(TOKEN_PLUS, "+", line, col);
-        case '-': advance(lexer); return create_token(TOKEN_MINUS, "-", line, col);
-        case '*': advance(lexer); return create_token(TOKEN_MUL, "*", line, col);
-        case '/': advance(lexer); return create_token(TOKEN_DIV, "/", line, col);
-        case ';': advance(lexer); return create_token(TOKEN_SEMICOLON, ";", line, col);
-        case '(': advance(lexer); return create_token(TOKEN_LPAREN, "(", line, col);
-        case ')': advance(lexer); return create_token(TOKEN_RPAREN, ")", line, col);
-        case '{': advance(lexer); return create_token(TOKEN_LBRACE, "{", line, col);
-        case '}': advance(lexer); return create_token(TOKEN_RBRACE, "}", line, col);
-        case ',': advance(lexer); return create_token(TOKEN_PUNCTUATION, ",", line, col);
-        default: {
-            char unknown[2] = { current, '\0' };
-            advance(lexer);
-            return create_token(TOKEN_ERROR, unknown, line, col);
+    } else if (state == S_NUMBER) {
+        // The value is decoded here once so the parser never re-parses the text
+        unsigned int value = 0;
+        for (size_t i = start; i < lexer->position; ++i) {
+            value = value * 10 + (unsigned int)(lexer->input[i] - '0');
         }
+        span_token(lexer, out, TOKEN_NUMBER);
+        out->number = (int)value;
+    } else {
+        span_token(lexer, out, (TokenType)dfa_accept[state]);
     }
 }
 
+Token* get_next_token(Lexer* lexer) {
+    Token* token = malloc(sizeof(Token));
+    lexer_scan_token(lexer, token);
+    return token;
+}
+
 void free_token(Token* token) {
-    if (token) {
-        free(token->value);
-        free(token);
-    }
+    // The text belongs to the lexer's source buffer, only the Token itself is ours
+    free(token);
 }
 
 void free_lexer(Lexer* lexer) {
     if (lexer) {
-        free((void*)lexer->input);
+        if (lexer->mapping) {
+#ifdef _WIN32
+            UnmapViewOfFile(lexer->mapping);
+#else
+            munmap(lexer->mapping, lexer->mapping_size);
+#endif
+        } else {
+            free((void*)lexer->input);
+        }
+        free_line_index(&lexer->lines);
         free(lexer);
     }
 }
 
-Lexer* create_lexer_from_file(const char* filename) {
-    FILE* file = fopen(filename, "r");
-    if (!file) {
-        perror("File open failed");
-        exit(1);
+// Maps `filename` read-only into memory. Returns NULL for empty files and
+// for inputs that cannot be mapped (pipes, devices); *size is set either way.
+static void* map_file(const char* filename, size_t* size) {
+    *size = 0;
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) return NULL;
+    LARGE_INTEGER file_size;
+    void* base = NULL;
+    if (GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0) {
+        HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping) {
+            base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);  // the view keeps the mapping alive
+            *size = (size_t)file_size.QuadPart;
+        }
     }
+    CloseHandle(file);
+    return base;
+#else
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return NULL;
+    struct stat st;
+    void* base = NULL;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (base == MAP_FAILED) {
+            base = NULL;
+        } else {
+            madvise(base, (size_t)st.st_size, MADV_SEQUENTIAL);
+            *size = (size_t)st.st_size;
+        }
+    }
+    close(fd);
+    return base;
+#endif
+}
 
-    fseek(file, 0, SEEK_END);
-    long size = ftell(file);
-    rewind(file);
+// Reads the whole stream into a single heap buffer (fallback when mapping is unavailable)
+static char* read_file(FILE* file, size_t* size) {
+    size_t capacity = 1 << 16;
+    size_t used = 0;
+    char* buffer = malloc(capacity);
+    size_t n;
+    while ((n = fread(buffer + used, 1, capacity - used, file)) > 0) {
+        used += n;
+        if (used == capacity) {
+            capacity *= 2;
+            buffer = realloc(buffer, capacity);
+        }
+    }
+    *size = used;
+    return buffer;
+}
 
-    char* buffer = malloc(size + 1);
-    fread(buffer, 1, size, file);
-    buffer[size] = '\0';
-    fclose(file);
+Lexer* create_lexer_from_file(const char* filename) {
+    size_t size;
+    char* buffer = map_file(filename, &size);
+    int mapped = buffer != NULL;
+    if (!mapped) {
+        FILE* file = fopen(filename, "rb");
+        if (!file) {
+            perror("File open failed");
+            exit(1);
+        }
+        buffer = read_file(file, &size);
+        fclose(file);
+    }
 
-    // Skip UTF-8 BOM if present
-    if ((unsigned char)buffer[0] == 0xEF &&
+    // Skip UTF-8 BOM if present by starting the lexer past it; the source is
+    // never copied, so peak memory stays at the size of the file
+    size_t skip = 0;
+    if (size >= 3 &&
+        (unsigned char)buffer[0] == 0xEF &&
         (unsigned char)buffer[1] == 0xBB &&
         (unsigned char)buffer[2] == 0xBF) {
-        Lexer* lexer = create_lexer(buffer + 3);
-        free(buffer);
-        return lexer;
+        skip = 3;
     }
 
-    return create_lexer(buffer);
+    Lexer* lexer = create_lexer_for_buffer(buffer + skip, size - skip);
+    if (mapped) {
+        lexer->mapping = buffer;
+        lexer->mapping_size = size;
+    } else if (skip) {
+        // free_lexer releases input, which must be the start of the allocation
+        memmove(buffer, buffer + skip, size - skip);
+        lexer->input = buffer;
+        lexer->lines.text = buffer;
+    }
+    return lexer;
 }
 
-Token* lexer_next_token(Lexer* lexer) {
-    return get_next_token(lexer);
-}
+Lexer* create_lexer_streaming(LexerRefillFn refill, void* ctx, size_t chunk_size) {
+    if (chunk_size == 0) chunk_size = LEXER_DEFAULT_CHUNK_SIZE;
+    Lexer* lexer = create_lexer_for_buffer(NULL, 0);
+    lexer->input = malloc(chunk_size);
+    lexer->refill = refill;
+    lexer->refill_ctx = ctx;
+    lexer->window_capacity = chunk_size;
+    lexer->chunk_size = chunk_size;
+    lexer->at_eof = 0;
 
-Token* lexer_peek_token(Lexer* lexer) {
-    int old_pos = lexer->position;
-    int old_line = lexer->line;
-    int old_col = lexer->column;
+    // Skip UTF-8 BOM if present; offsets start after it, as for files
+    while (lexer->length < 3 && refill_window(lexer)) {
+    }
+    if (lexer->length >= 3 &&
+        (unsigned char)lexer->input[0] == 0xEF &&
+        (unsigned char)lexer->input[1] == 0xBB &&
+        (unsigned char)lexer->input[2] == 0xBF) {
+        lexer->length -= 3;
+        memmove((char*)lexer->input, lexer->input + 3, lexer->length);
+        // Offsets start after the BOM, so index the window again
+        free_line_index(&lexer->lines);
+        line_index_init(&lexer->lines, NULL, 0);
+        line_index_feed(&lexer->lines, lexer->input, lexer->length);
+    }
+    return lexer;
+}
 
-    Token* token = get_next_token(lexer);
+static size_t refill_from_stream(void* ctx, char* buffer, size_t capacity) {
+    return fread(buffer, 1, capacity, (FILE*)ctx);
+}
 
-    lexer->position = old_pos;
-    lexer->line = old_line;
-    lexer->column = old_col;
+Lexer* create_lexer_from_stream(FILE* stream) {
+    return create_lexer_streaming(refill_from_stream, stream, LEXER_DEFAULT_CHUNK_SIZE);
+}
 
-    return token;
+Token* lexer_next_token(Lexer* lexer) {
+    return get_next_token(lexer);
 }
 
 void print_tokens(Lexer* lexer) {
@@ -223,7 +353,7 @@ void print_tokens(Lexer* lexer) {
     do {
         token = get_next_token(lexer);
         if (token) {
-            fprintf(stderr, "[LEXER DEBUG] Token: type=%d, value='%s'\n", token->type, token->value ? token->value : "(null)");
+            fprintf(stderr, "[LEXER DEBUG] Token: type=%d, value='%.*s'\n", token->type, (int)token->length, token->text);
         }
     } while (token && token->type != TOKEN_EOF);
 }
@@ -2,23 +2,61 @@
 #define LEXER_H
 
 #include "token.h"
+#include "../utils/line_index.h"
+#include <stddef.h>
+#include <stdio.h>
 
+// Streaming input: copies up to `capacity` bytes into `buffer` and returns
+// how many were written; 0 means end of input.
+typedef size_t (*LexerRefillFn)(void* ctx, char* buffer, size_t capacity);
+
+#define LEXER_DEFAULT_CHUNK_SIZE (64 * 1024)
+#define LEXER_RETAIN_NONE ((size_t)-1)
+
+// The input is addressed with 64-bit offsets and is not required to be
+// NUL-terminated: a memory-mapped file is lexed in place up to `length`.
+//
+// In streaming mode `input` is a window onto the source: it holds the bytes
+// [base, base + length) and is refilled chunk by chunk through `refill`.
+// Refilling discards everything before the current token and before
+// `retain`, so a token's text pointer is only valid until the next token is
+// lexed unless its offset is retained (the parser retains its lookahead).
+//
+// The lexer does not track lines and columns; `lines` resolves token
+// offsets to positions when a diagnostic needs them.
 typedef struct Lexer {
-    const char* input;  // The source code string
-    int position;       // Current index in input
-    int line;
-    int column;
+    const char* input;  // The source code buffer (or streaming window)
+    size_t length;      // Number of bytes in input
+    size_t position;    // Current index in input
+    LineIndex lines;
+    void* mapping;      // Base of the read-only file mapping, NULL if input is heap-owned
+    size_t mapping_size;
+
+    size_t base;            // Source offset of input[0] (always 0 unless streaming)
+    size_t token_start;     // Index in input where the token being lexed starts
+    size_t retain;          // Source offset whose bytes must survive a refill
+    LexerRefillFn refill;   // NULL for whole-buffer input
+    void* refill_ctx;
+    size_t window_capacity;
+    size_t chunk_size;
+    int at_eof;
+    int intern_identifiers;  // 0: identifier tokens get ATOM_NONE (used by parallel workers)
 } Lexer;
 
 Lexer* create_lexer(const char* input);
+// Initializes a caller-owned lexer over borrowed bytes, which must outlive it.
+// Nothing is allocated, so it is simply dropped instead of passed to free_lexer.
+void lexer_init_span(Lexer* lexer, const char* input, size_t length);
 Token* get_next_token(Lexer* lexer);
+void lexer_scan_token(Lexer* lexer, Token* out);  // Allocation-free: fills a caller-owned token
 void free_token(Token* token);
 void free_lexer(Lexer* lexer);
 Lexer* create_lexer_from_file(const char* filename);
-Token* lexer_next_token(Lexer* lexer);     // Needed for parser
-Token* lexer_peek_token(Lexer* lexer);     // Needed for lookahead
+Lexer* create_lexer_streaming(LexerRefillFn refill, void* ctx, size_t chunk_size);
+Lexer* create_lexer_from_stream(FILE* stream);  // e.g. stdin; read in LEXER_DEFAULT_CHUNK_SIZE chunks
+Token* lexer_next_token(Lexer* lexer);     // Same as get_next_token; the parser buffers lookahead itself
 
-Token* create_token(TokenType type, const char* value, int line, int column);
+Token* create_token(TokenType type, const char* text, size_t length, size_t offset);
 
 
 #endif // LEXER_H
@@ -0,0 +1,244 @@
+#include "lexer_scan.h"
+#include <stdint.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define LEXER_SCAN_X86 1
+#include <immintrin.h>
+#endif
+
+// ---------------------------------------------------------------------------
+// Scalar kernels (also used for the tails shorter than one vector)
+// ---------------------------------------------------------------------------
+
+static inline int is_ws_byte(unsigned char c) {
+    return c == ' ' || (unsigned char)(c - '\t') <= ('\r' - '\t');
+}
+
+static inline int is_ident_byte(unsigned char c) {
+    return (unsigned char)((c | 0x20) - 'a') < 26 || (unsigned char)(c - '0') < 10 || c == '_';
+}
+
+static inline int is_digit_byte(unsigned char c) {
+    return (unsigned char)(c - '0') < 10;
+}
+
+static size_t scan_whitespace_scalar(const char* p, size_t n) {
+    size_t i = 0;
+    while (i < n && is_ws_byte((unsigned char)p[i])) ++i;
+    return i;
+}
+
+static size_t scan_identifier_scalar(const char* p, size_t n) {
+    size_t i = 0;
+    while (i < n && is_ident_byte((unsigned char)p[i])) ++i;
+    return i;
+}
+
+static size_t scan_digits_scalar(const char* p, size_t n) {
+    size_t i = 0;
+    while (i < n && is_digit_byte((unsigned char)p[i])) ++i;
+    return i;
+}
+
+#ifdef LEXER_SCAN_X86
+
+// ---------------------------------------------------------------------------
+// SSE2 kernels: 16 bytes per step. Unsigned range checks are done with
+// (x - lo) <= (hi - lo), expressed as min_epu8(x - lo, hi - lo) == x - lo.
+// ---------------------------------------------------------------------------
+
+__attribute__((target("sse2")))
+static inline __m128i in_range_sse2(__m128i x, char lo, char span) {
+    __m128i d = _mm_sub_epi8(x, _mm_set1_epi8(lo));
+    return _mm_cmpeq_epi8(_mm_min_epu8(d, _mm_set1_epi8(span)), d);
+}
+
+__attribute__((target("sse2")))
+static inline __m128i ws_mask_sse2(__m128i x) {
+    return _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8(' ')),
+                        in_range_sse2(x, '\t', '\r' - '\t'));
+}
+
+__attribute__((target("sse2")))
+static inline __m128i ident_mask_sse2(__m128i x) {
+    __m128i alpha = in_range_sse2(_mm_or_si128(x, _mm_set1_epi8(0x20)), 'a', 25);
+    __m128i digit = in_range_sse2(x, '0', 9);
+    __m128i under = _mm_cmpeq_epi8(x, _mm_set1_epi8('_'));
+    return _mm_or_si128(_mm_or_si128(alpha, digit), under);
+}
+
+__attribute__((target("sse2")))
+static size_t scan_whitespace_sse2(const char* p, size_t n) {
+    size_t i = 0;
+    while (i + 16 <= n) {
+        unsigned m = (unsigned)_mm_movemask_epi8(ws_mask_sse2(_mm_loadu_si128((const __m128i*)(p + i))));
+        if (m != 0xFFFF) return i + (size_t)__builtin_ctz(~m);
+        i += 16;
+    }
+    return i + scan_whitespace_scalar(p + i, n - i);
+}
+
+__attribute__((target("sse2")))
+static size_t scan_identifier_sse2(const char* p, size_t n) {
+    size_t i = 0;
+    while (i + 16 <= n) {
+        unsigned m = (unsigned)_mm_movemask_epi8(ident_mask_sse2(_mm_loadu_si128((const __m128i*)(p + i))));
+        if (m != 0xFFFF) return i + (size_t)__builtin_ctz(~m);
+        i += 16;
+    }
+    return i + scan_identifier_scalar(p + i, n - i);
+}
+
+__attribute__((target("sse2")))
+static size_t scan_digits_sse2(const char* p, size_t n) {
+    size_t i = 0;
+    while (i + 16 <= n) {
+        unsigned m = (unsigned)_mm_movemask_epi8(in_range_sse2(_mm_loadu_si128((const __m128i*)(p + i)), '0', 9));
+        if (m != 0xFFFF) return i + (size_t)__builtin_ctz(~m);
+        i += 16;
+    }
+    return i + scan_digits_scalar(p + i, n - i);
+}
+
+// ---------------------------------------------------------------------------
+// AVX2 kernels: same logic as SSE2, 32 bytes per step
+// ---------------------------------------------------------------------------
+
+__attribute__((target("avx2")))
+static inline __m256i in_range_avx2(__m256i x, char lo, char span) {
+    __m256i d = _mm256_sub_epi8(x, _mm256_set1_epi8(lo));
+    return _mm256_cmpeq_epi8(_mm256_min_epu8(d, _mm256_set1_epi8(span)), d);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i ident_mask_avx2(__m256i x) {
+    __m256i alpha = in_range_avx2(_mm256_or_si256(x, _mm256_set1_epi8(0x20)), 'a', 25);
+    __m256i digit = in_range_avx2(x, '0', 9);
+    __m256i under = _mm256_cmpeq_epi8(x, _mm256_set1_epi8('_'));
+    return _mm256_or_si256(_mm256_or_si256(alpha, digit), under);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i ws_mask_avx2(__m256i x) {
+    return _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8(' ')),
+                           in_range_avx2(x, '\t', '\r' - '\t'));
+}
+
+__attribute__((target("avx2")))
+static size_t scan_whitespace_avx2(const char* p, size_t n) {
+    size_t i = 0;
+    while (i + 32 <= n) {
+        uint32_t m = (uint32_t)_mm256_movemask_epi8(ws_mask_avx2(_mm256_loadu_si256((const __m256i*)(p + i))));
+        if (m != 0xFFFFFFFFu) return i + (size_t)__builtin_ctz(~m);
+        i += 32;
+    }
+    return i + scan_whitespace_sse2(p + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static size_t scan_identifier_avx2(const char* p, size_t n) {
+    size_t i = 0;
+    while (i + 32 <= n) {
+        uint32_t m = (uint32_t)_mm256_movemask_epi8(ident_mask_avx2(_mm256_loadu_si256((const __m256i*)(p + i))));
+        if (m != 0xFFFFFFFFu) return i + (size_t)__builtin_ctz(~m);
+        i += 32;
+    }
+    return i + scan_identifier_sse2(p + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static size_t scan_digits_avx2(const char* p, size_t n) {
+    size_t i = 0;
+    while (i + 32 <= n) {
+        uint32_t m = (uint32_t)_mm256_movemask_epi8(in_range_avx2(_mm256_loadu_si256((const __m256i*)(p + i)), '0', 9));
+        if (m != 0xFFFFFFFFu) return i + (size_t)__builtin_ctz(~m);
+        i += 32;
+    }
+    return i + scan_digits_sse2(p + i, n - i);
+}
+
+#endif // LEXER_SCAN_X86
+
+// ---------------------------------------------------------------------------
+// Runtime dispatch
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    LexerScanKind kind;
+    size_t (*whitespace)(const char*, size_t);
+    size_t (*identifier)(const char*, size_t);
+    size_t (*digits)(const char*, size_t);
+} ScanOps;
+
+static const ScanOps scan_ops[] = {
+    { LEXER_SCAN_SCALAR, scan_whitespace_scalar, scan_identifier_scalar, scan_digits_scalar },
+#ifdef LEXER_SCAN_X86
+    { LEXER_SCAN_SSE2, scan_whitespace_sse2, scan_identifier_sse2, scan_digits_sse2 },
+    { LEXER_SCAN_AVX2, scan_whitespace_avx2, scan_identifier_avx2, scan_digits_avx2 },
+#endif
+};
+
+static const ScanOps* active_ops = NULL;
+
+static int cpu_supports(LexerScanKind kind) {
+#ifdef LEXER_SCAN_X86
+    __builtin_cpu_init();
+    switch (kind) {
+        case LEXER_SCAN_SCALAR: return 1;
+        case LEXER_SCAN_SSE2: return __builtin_cpu_supports("sse2");
+        case LEXER_SCAN_AVX2: return __builtin_cpu_supports("avx2");
+    }
+    return 0;
+#else
+    return kind == LEXER_SCAN_SCALAR;
+#endif
+}
+
+static const ScanOps* resolve_ops(void) {
+    const ScanOps* best = &scan_ops[0];
+    for (size_t i = 1; i < sizeof(scan_ops) / sizeof(scan_ops[0]); ++i) {
+        if (cpu_supports(scan_ops[i].kind)) best = &scan_ops[i];
+    }
+    active_ops = best;
+    return best;
+}
+
+static inline const ScanOps* ops(void) {
+    const ScanOps* o = active_ops;
+    return o ? o : resolve_ops();
+}
+
+int lexer_scan_select(LexerScanKind kind) {
+    for (size_t i = 0; i < sizeof(scan_ops) / sizeof(scan_ops[0]); ++i) {
+        if (scan_ops[i].kind == kind && cpu_supports(kind)) {
+            active_ops = &scan_ops[i];
+            return 1;
+        }
+    }
+    return 0;
+}
+
+LexerScanKind lexer_scan_active(void) {
+    return ops()->kind;
+}
+
+const char* lexer_scan_name(LexerScanKind kind) {
+    switch (kind) {
+        case LEXER_SCAN_SCALAR: return "scalar";
+        case LEXER_SCAN_SSE2: return "sse2";
+        case LEXER_SCAN_AVX2: return "avx2";
+    }
+    return "unknown";
+}
+
+size_t scan_whitespace(const char* p, size_t n) {
+    return ops()->whitespace(p, n);
+}
+
+size_t scan_identifier(const char* p, size_t n) {
+    return ops()->identifier(p, n);
+}
+
+size_t scan_digits(const char* p, size_t n) {
+    return ops()->digits(p, n);
+}
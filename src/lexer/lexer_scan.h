@@ -0,0 +1,30 @@
+#ifndef LEXER_SCAN_H
+#define LEXER_SCAN_H
+
+#include <stddef.h>
+
+// Run-scanning kernels used by the lexer's hot loops. Each kernel returns the
+// length of the longest prefix of [p, p + n) made of the given byte class.
+// The classes are fixed ASCII sets and do not depend on the C locale:
+//   whitespace: ' ', '\t', '\n', '\v', '\f', '\r'
+//   identifier: [A-Za-z0-9_]
+//   digits:     [0-9]
+
+typedef enum {
+    LEXER_SCAN_SCALAR,
+    LEXER_SCAN_SSE2,
+    LEXER_SCAN_AVX2
+} LexerScanKind;
+
+size_t scan_whitespace(const char* p, size_t n);
+size_t scan_identifier(const char* p, size_t n);
+size_t scan_digits(const char* p, size_t n);
+
+// The best kernel supported by the running CPU is picked on first use.
+// lexer_scan_select forces a specific kernel (benchmarks, tests) and returns
+// 0 if the CPU does not support it.
+int lexer_scan_select(LexerScanKind kind);
+LexerScanKind lexer_scan_active(void);
+const char* lexer_scan_name(LexerScanKind kind);
+
+#endif // LEXER_SCAN_H
@@ -0,0 +1,127 @@
+#ifndef LEXER_TABLES_H
+#define LEXER_TABLES_H
+
+// Precomputed tables driving get_next_token. Only included by lexer.c.
+//
+// Every input byte maps to a character class; the token DFA transitions on
+// classes, so no <ctype.h> (and therefore no locale) is involved.
+
+#include <stdint.h>
+#include "token.h"
+
+typedef enum {
+    C_EOF,  // '\0' or end of input
+    C_SPC,  // ' ', '\t', '\n' (only reached after a skipped byte, see get_next_token)
+    C_SKP,  // non-ASCII and control bytes, silently skipped
+    C_ALP,  // [A-Za-z_]
+    C_DIG,  // [0-9]
+    C_PLS, C_MIN, C_MUL, C_DIV,
+    C_SEM, C_LPR, C_RPR, C_LBR, C_RBR, C_COM,
+    C_EQL,  // =
+    C_BNG,  // !
+    C_LES,  // <
+    C_GRT,  // >
+    C_OTH,  // any other printable ASCII byte
+    CHAR_CLASS_COUNT
+} CharClass;
+
+static const uint8_t char_class[256] = {
+    C_EOF, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SPC, C_SPC, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP,  // 00
+    C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP,  // 10
+    C_SPC, C_BNG, C_OTH, C_OTH, C_OTH, C_OTH, C_OTH, C_OTH, C_LPR, C_RPR, C_MUL, C_PLS, C_COM, C_MIN, C_OTH, C_DIV,  // 20
+    C_DIG, C_DIG, C_DIG, C_DIG, C_DIG, C_DIG, C_DIG, C_DIG, C_DIG, C_DIG, C_OTH, C_SEM, C_LES, C_EQL, C_GRT, C_OTH,  // 30
+    C_OTH, C_ALP, C_ALP, C_ALP, C_ALP, C_ALP, C_ALP, C_ALP, C_ALP, C_ALP, C_ALP, C_ALP, C_ALP, C_ALP, C_ALP, C_ALP,  // 40
+    C_ALP, C_ALP, C_ALP, C_ALP, C_ALP, C_ALP, C_ALP, C_ALP, C_ALP, C_ALP, C_ALP, C_OTH, C_OTH, C_OTH, C_OTH, C_ALP,  // 50
+    C_OTH, C_ALP, C_ALP, C_ALP, C_ALP, C_ALP, C_ALP, C_ALP, C_ALP, C_ALP, C_ALP, C_ALP, C_ALP, C_ALP, C_ALP, C_ALP,  // 60
+    C_ALP, C_ALP, C_ALP, C_ALP, C_ALP, C_ALP, C_ALP, C_ALP, C_ALP, C_ALP, C_ALP, C_LBR, C_OTH, C_RBR, C_OTH, C_OTH,  // 70
+    C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP,  // 80
+    C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP,  // 90
+    C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP,  // A0
+    C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP,  // B0
+    C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP,  // C0
+    C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP,  // D0
+    C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP,  // E0
+    C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP, C_SKP,  // F0
+};
+
+// DFA states. S_STOP is 0 so that every transition left out of the table
+// below means "the token ends before this byte".
+typedef enum {
+    S_STOP,
+    S_START,
+    S_IDENT, S_NUMBER,
+    S_ASSIGN, S_EQ, S_BANG, S_NEQ, S_LT, S_LE, S_GT, S_GE,
+    S_PLUS, S_MINUS, S_MUL, S_DIV,
+    S_SEMI, S_LPAREN, S_RPAREN, S_LBRACE, S_RBRACE, S_COMMA,
+    S_ERROR,
+    DFA_STATE_COUNT
+} DfaState;
+
+static const uint8_t dfa_next[DFA_STATE_COUNT][CHAR_CLASS_COUNT] = {
+    [S_START] = {
+        [C_SPC] = S_ERROR, [C_ALP] = S_IDENT, [C_DIG] = S_NUMBER,
+        [C_PLS] = S_PLUS, [C_MIN] = S_MINUS, [C_MUL] = S_MUL, [C_DIV] = S_DIV,
+        [C_SEM] = S_SEMI, [C_LPR] = S_LPAREN, [C_RPR] = S_RPAREN,
+        [C_LBR] = S_LBRACE, [C_RBR] = S_RBRACE, [C_COM] = S_COMMA,
+        [C_EQL] = S_ASSIGN, [C_BNG] = S_BANG, [C_LES] = S_LT, [C_GRT] = S_GT,
+        [C_OTH] = S_ERROR,
+    },
+    [S_IDENT]  = { [C_ALP] = S_IDENT, [C_DIG] = S_IDENT },
+    [S_NUMBER] = { [C_DIG] = S_NUMBER },
+    [S_ASSIGN] = { [C_EQL] = S_EQ },
+    [S_BANG]   = { [C_EQL] = S_NEQ },
+    [S_LT]     = { [C_EQL] = S_LE },
+    [S_GT]     = { [C_EQL] = S_GE },
+};
+
+// Token produced when the DFA stops in a state. S_IDENT is refined by the
+// keyword lookup below.
+static const uint8_t dfa_accept[DFA_STATE_COUNT] = {
+    [S_START] = TOKEN_EOF,
+    [S_IDENT] = TOKEN_IDENTIFIER, [S_NUMBER] = TOKEN_NUMBER,
+    [S_ASSIGN] = TOKEN_ASSIGN, [S_EQ] = TOKEN_EQ,
+    [S_BANG] = TOKEN_ERROR, [S_NEQ] = TOKEN_NEQ,
+    [S_LT] = TOKEN_LT, [S_LE] = TOKEN_LE, [S_GT] = TOKEN_GT, [S_GE] = TOKEN_GE,
+    [S_PLUS] = TOKEN_PLUS, [S_MINUS] = TOKEN_MINUS, [S_MUL] = TOKEN_MUL, [S_DIV] = TOKEN_DIV,
+    [S_SEMI] = TOKEN_SEMICOLON, [S_LPAREN] = TOKEN_LPAREN, [S_RPAREN] = TOKEN_RPAREN,
+    [S_LBRACE] = TOKEN_LBRACE, [S_RBRACE] = TOKEN_RBRACE, [S_COMMA] = TOKEN_PUNCTUATION,
+    [S_ERROR] = TOKEN_ERROR,
+};
+
+// Keywords are found with a perfect hash over (first byte, last byte, length).
+// Each keyword is placed at its hash slot by a constant-expression designator.
+// When adding a keyword, add it to KEYWORD_SLOT_BITS too; if the assertion
+// below fails, pick new multipliers that keep the slots distinct and, if
+// needed, grow KEYWORD_SLOTS to the next power of two.
+#define KEYWORD_SLOTS 8
+#define KEYWORD_HASH(first, last, len) \
+    (((unsigned)(unsigned char)(first) + 5u * (unsigned)(unsigned char)(last) + (unsigned)(len)) & (KEYWORD_SLOTS - 1))
+
+#define KEYWORD_SLOT_IF KEYWORD_HASH('i', 'f', 2)
+#define KEYWORD_SLOT_ELSE KEYWORD_HASH('e', 'e', 4)
+#define KEYWORD_SLOT_WHILE KEYWORD_HASH('w', 'e', 5)
+#define KEYWORD_SLOT_RETURN KEYWORD_HASH('r', 'n', 6)
+#define KEYWORD_SLOT_INT KEYWORD_HASH('i', 't', 3)
+
+// One bit per keyword slot: summing and or-ing the bits agree only when no
+// two keywords share a slot
+#define KEYWORD_SLOT_BITS(op) \
+    ((1u << KEYWORD_SLOT_IF) op (1u << KEYWORD_SLOT_ELSE) op (1u << KEYWORD_SLOT_WHILE) op \
+     (1u << KEYWORD_SLOT_RETURN) op (1u << KEYWORD_SLOT_INT))
+_Static_assert(KEYWORD_SLOT_BITS(+) == KEYWORD_SLOT_BITS(|), "two keywords hash to the same slot");
+
+typedef struct {
+    const char* text;
+    uint8_t length;
+    uint8_t type;
+} KeywordSlot;
+
+static const KeywordSlot keyword_slots[KEYWORD_SLOTS] = {
+    [KEYWORD_SLOT_IF] = { "if", 2, TOKEN_IF },
+    [KEYWORD_SLOT_ELSE] = { "else", 4, TOKEN_ELSE },
+    [KEYWORD_SLOT_WHILE] = { "while", 5, TOKEN_WHILE },
+    [KEYWORD_SLOT_RETURN] = { "return", 6, TOKEN_RETURN },
+    [KEYWORD_SLOT_INT] = { "int", 3, TOKEN_INT },
+};
+
+#endif // LEXER_TABLES_H
@@ -31,13 +31,29 @@ typedef enum {
     TOKEN_NEQ     // !=
 } TokenType;
 
+#include <stddef.h>  // for size_t
+#include "../utils/intern.h"
+#include "../utils/line_index.h"
+
+// A token is a span into the lexer's source buffer: no text is copied.
+// `text` is NOT NUL-terminated; print it with "%.*s", (int)length, text.
 typedef struct Token {
     TokenType type;
-    char* value;   // dynamically allocated string for token text
-    int line;      // line number in source code
-    int column;    // column number in source code
+    const char* text;  // start of the token text inside the source buffer
+    size_t length;     // number of bytes in text
+    size_t offset;     // byte offset of the token from the start of the source
+    union {
+        int number;    // decoded value for TOKEN_NUMBER, 0 otherwise
+        Atom atom;     // interned name for TOKEN_IDENTIFIER
+    };
 } Token;
 
+// Source position kept by AST nodes, so they do not pin their tokens.
+// Line and column are resolved from the offset only when reporting errors.
+typedef struct SourceLoc {
+    size_t offset;  // SOURCE_OFFSET_NONE for nodes without a leading token
+} SourceLoc;
+
 void free_token(Token* token);
 
 #endif // TOKEN_H
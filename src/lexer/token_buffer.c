@@ -0,0 +1,230 @@
+#include "token_buffer.h"
+#include "lexer_scan.h"
+#include "../utils/trace.h"
+#include "../utils/parallel.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int grow_token_buffer(TokenBuffer* tokens, size_t capacity) {
+    uint8_t* types = realloc(tokens->types, capacity * sizeof(uint8_t));
+    if (types) tokens->types = types;
+    uint32_t* offsets = realloc(tokens->offsets, capacity * sizeof(uint32_t));
+    if (offsets) tokens->offsets = offsets;
+    uint32_t* lengths = realloc(tokens->lengths, capacity * sizeof(uint32_t));
+    if (lengths) tokens->lengths = lengths;
+    uint32_t* payloads = realloc(tokens->payloads, capacity * sizeof(uint32_t));
+    if (payloads) tokens->payloads = payloads;
+    if (!types || !offsets || !lengths || !payloads) return 0;
+    tokens->capacity = capacity;
+    return 1;
+}
+
+static TokenBuffer* create_token_buffer(const char* source, size_t capacity) {
+    TokenBuffer* tokens = calloc(1, sizeof(TokenBuffer));
+    if (!tokens) return NULL;
+    tokens->source = source;
+    if (!grow_token_buffer(tokens, capacity)) {
+        free_token_buffer(tokens);
+        return NULL;
+    }
+    return tokens;
+}
+
+// Appends every remaining token of `lexer`, up to and including TOKEN_EOF.
+// When the lexer does not intern, identifier payloads hold intern_hash()
+// values instead of atoms.
+static int scan_into(Lexer* lexer, TokenBuffer* tokens) {
+    Token token;
+    do {
+        lexer_scan_token(lexer, &token);
+        if (tokens->count == tokens->capacity && !grow_token_buffer(tokens, tokens->capacity * 2)) {
+            return 0;
+        }
+        size_t i = tokens->count++;
+        tokens->types[i] = (uint8_t)token.type;
+        tokens->offsets[i] = (uint32_t)token.offset;
+        tokens->lengths[i] = (uint32_t)token.length;
+        if (token.type == TOKEN_NUMBER) {
+            tokens->payloads[i] = (uint32_t)token.number;
+        } else if (token.type == TOKEN_IDENTIFIER && !lexer->intern_identifiers) {
+            tokens->payloads[i] = intern_hash(token.text, token.length);
+        } else {
+            tokens->payloads[i] = token.atom;
+        }
+    } while (token.type != TOKEN_EOF);
+    return 1;
+}
+
+static int check_batch_input(const Lexer* lexer) {
+    if (lexer->refill) {
+        fprintf(stderr, "Error: batch tokenization needs a whole-buffer lexer, not a stream\n");
+        return 0;
+    }
+    if (lexer->length > UINT32_MAX) {
+        fprintf(stderr, "Error: source of %zu bytes is too large for batch tokenization\n", lexer->length);
+        return 0;
+    }
+    return 1;
+}
+
+TokenBuffer* lexer_tokenize(Lexer* lexer) {
+    if (!lexer || !check_batch_input(lexer)) return NULL;
+
+    // Typical sources average a little over four bytes per token
+    TokenBuffer* tokens = create_token_buffer(lexer->input, (lexer->length - lexer->position) / 4 + 16);
+    if (!tokens) return NULL;
+    if (!scan_into(lexer, tokens)) {
+        fprintf(stderr, "Error: out of memory while tokenizing\n");
+        free_token_buffer(tokens);
+        return NULL;
+    }
+    return tokens;
+}
+
+// ---------------------------------------------------------------------------
+// Parallel tokenization
+// ---------------------------------------------------------------------------
+
+// One slice of the source, lexed by its own thread with chunk-relative offsets
+typedef struct LexChunk {
+    const char* input;
+    size_t start;  // index of input[0] in the whole source
+    size_t length;
+    TokenBuffer* tokens;
+    int ok;
+} LexChunk;
+
+static void lex_chunk(LexChunk* chunk) {
+    Lexer lexer;
+    lexer_init_span(&lexer, chunk->input, chunk->length);
+    lexer.intern_identifiers = 0;  // atoms are assigned in source order while stitching
+    chunk->tokens = create_token_buffer(chunk->input, chunk->length / 4 + 16);
+    chunk->ok = chunk->tokens && scan_into(&lexer, chunk->tokens);
+}
+
+static void lex_chunk_task(void* chunks, size_t index) {
+    lex_chunk((LexChunk*)chunks + index);
+}
+
+int lexer_cpu_count(void) {
+    return parallel_cpu_count();
+}
+
+// Splits [begin, end) into at most `threads` chunks. Every chunk after the
+// first starts right after a '\n': the sequential lexer is always between
+// tokens there, since no token contains a newline (a stray one after skipped
+// bytes is a one-byte error token), so a fresh lexer produces the same tokens.
+static size_t split_chunks(const char* input, size_t begin, size_t end, int threads,
+                           size_t min_chunk, LexChunk* chunks) {
+    size_t total = end - begin;
+    size_t target = total / (size_t)threads;
+    if (target < min_chunk) target = min_chunk;
+
+    size_t count = 0;
+    size_t start = begin;
+    while (start < end) {
+        size_t stop = end;
+        if (count + 1 < (size_t)threads && end - start > target) {
+            const char* nl = memchr(input + start + target, '\n', end - start - target);
+            if (nl) stop = (size_t)(nl - input) + 1;
+        }
+        chunks[count].input = input + start;
+        chunks[count].start = start;
+        chunks[count].length = stop - start;
+        chunks[count].tokens = NULL;
+        chunks[count].ok = 0;
+        count++;
+        start = stop;
+    }
+    return count;
+}
+
+// Concatenates the chunk buffers into one, rebasing offsets and interning
+// identifiers in source order so atoms match a sequential run. A chunk's
+// TOKEN_EOF is dropped unless it came before the end of the chunk (a NUL
+// byte ends the input early) or the chunk is the last one.
+static TokenBuffer* stitch_chunks(const char* source, LexChunk* chunks, size_t count) {
+    size_t total = 0;
+    for (size_t c = 0; c < count; ++c) total += chunks[c].tokens->count;
+    TokenBuffer* tokens = create_token_buffer(source, total);
+    if (!tokens) return NULL;
+
+    for (size_t c = 0; c < count; ++c) {
+        const TokenBuffer* part = chunks[c].tokens;
+        size_t n = part->count;
+        int ends_input = c + 1 == count || part->offsets[n - 1] < chunks[c].length;
+        if (!ends_input) n--;  // the EOF at the chunk boundary
+
+        size_t base = tokens->count;
+        memcpy(tokens->types + base, part->types, n * sizeof(uint8_t));
+        memcpy(tokens->lengths + base, part->lengths, n * sizeof(uint32_t));
+        for (size_t i = 0; i < n; ++i) {
+            uint32_t offset = part->offsets[i] + (uint32_t)chunks[c].start;
+            tokens->offsets[base + i] = offset;
+            tokens->payloads[base + i] = part->types[i] == TOKEN_IDENTIFIER
+                ? intern_hashed(source + offset, part->lengths[i], part->payloads[i])
+                : part->payloads[i];
+            if (tokens->payloads[base + i] == ATOM_NONE && part->types[i] == TOKEN_IDENTIFIER) {
+                free_token_buffer(tokens);
+                return NULL;
+            }
+        }
+        tokens->count += n;
+        if (ends_input) break;
+    }
+    return tokens;
+}
+
+TokenBuffer* lexer_tokenize_parallel(Lexer* lexer, int threads, size_t min_chunk) {
+    if (!lexer || !check_batch_input(lexer)) return NULL;
+    if (threads <= 0) threads = lexer_cpu_count();
+    if (min_chunk == 0) min_chunk = LEXER_PARALLEL_MIN_CHUNK;
+    if (threads == 1 || lexer->length - lexer->position < 2 * min_chunk) {
+        return lexer_tokenize(lexer);
+    }
+
+    LexChunk* chunks = malloc((size_t)threads * sizeof(LexChunk));
+    if (!chunks) return NULL;
+    size_t count = split_chunks(lexer->input, lexer->position, lexer->length, threads, min_chunk, chunks);
+    TRACE(TRACE_LEXER, "split", "bytes=%zu chunks=%zu", lexer->length - lexer->position, count);
+
+    // Resolve the scanning kernel before the workers race to do it
+    lexer_scan_active();
+
+    parallel_for(count, (int)count, lex_chunk_task, chunks);
+
+    TokenBuffer* tokens = NULL;
+    int ok = 1;
+    for (size_t c = 0; c < count; ++c) ok = ok && chunks[c].ok;
+    if (ok) tokens = stitch_chunks(lexer->input, chunks, count);
+    if (!tokens) fprintf(stderr, "Error: out of memory while tokenizing\n");
+
+    for (size_t c = 0; c < count; ++c) free_token_buffer(chunks[c].tokens);
+    free(chunks);
+    lexer->position = lexer->length;
+    lexer->token_start = lexer->position;
+    return tokens;
+}
+
+void token_buffer_get(const TokenBuffer* tokens, size_t index, Token* out) {
+    if (index >= tokens->count) index = tokens->count - 1;
+    out->type = (TokenType)tokens->types[index];
+    out->offset = tokens->offsets[index];
+    out->text = tokens->source + out->offset;
+    out->length = tokens->lengths[index];
+    if (out->type == TOKEN_NUMBER) {
+        out->number = (int)tokens->payloads[index];
+    } else {
+        out->atom = tokens->payloads[index];
+    }
+}
+
+void free_token_buffer(TokenBuffer* tokens) {
+    if (!tokens) return;
+    free(tokens->types);
+    free(tokens->offsets);
+    free(tokens->lengths);
+    free(tokens->payloads);
+    free(tokens);
+}
@@ -0,0 +1,42 @@
+#ifndef TOKEN_BUFFER_H
+#define TOKEN_BUFFER_H
+
+#include "lexer.h"
+#include <stdint.h>
+
+// Batch tokenization: the whole source is lexed up front into parallel
+// arrays, one entry per token (13 bytes), instead of one Token struct per
+// call. Token i is (types[i], offsets[i], lengths[i], payloads[i]); the last
+// entry is always TOKEN_EOF. Offsets are 32-bit, so batch mode is limited to
+// sources under 4 GiB; larger inputs must be streamed.
+typedef struct TokenBuffer {
+    uint8_t* types;      // TokenType
+    uint32_t* offsets;   // byte offset of the token in `source`
+    uint32_t* lengths;
+    uint32_t* payloads;  // number value for TOKEN_NUMBER, Atom for TOKEN_IDENTIFIER
+    size_t count;
+    size_t capacity;
+    const char* source;  // the lexer's input; must outlive the buffer
+} TokenBuffer;
+
+// Lexes everything left in a whole-buffer lexer. Returns NULL for streaming
+// lexers (their window does not keep the source alive) and oversized inputs.
+TokenBuffer* lexer_tokenize(Lexer* lexer);
+
+// Same result as lexer_tokenize, with the source split at line boundaries
+// into up to `threads` chunks that are lexed concurrently (threads <= 0 uses
+// one per CPU). Chunks are at least `min_chunk` bytes (0 selects
+// LEXER_PARALLEL_MIN_CHUNK), so small inputs are lexed on the calling thread.
+// Identifiers are interned on the calling thread while the chunks are
+// joined, so atoms are numbered exactly as in a sequential run.
+#define LEXER_PARALLEL_MIN_CHUNK (1 << 20)
+TokenBuffer* lexer_tokenize_parallel(Lexer* lexer, int threads, size_t min_chunk);
+int lexer_cpu_count(void);
+
+// Materializes token `index` into a caller-owned Token; indexes past the
+// end yield the trailing TOKEN_EOF.
+void token_buffer_get(const TokenBuffer* tokens, size_t index, Token* out);
+
+void free_token_buffer(TokenBuffer* tokens);
+
+#endif // TOKEN_BUFFER_H
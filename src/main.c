@@ -1,86 +1,223 @@
 #include <stdio.h>
 #include "lexer/lexer.h"
+#include "lexer/token_buffer.h"
 #include "parser/parser.h"
 #include "semantic/semantic_analyzer.h"
 #include "parser/ast.h"
+#include "parser/ast_pool.h"
 #include "utils/symbol_table.h"
+#include "utils/error_handler.h"
 #include "ir/ir_generator.h" // Include the IR generator header
 #include "codegen/asm_generator.h"
+#include "utils/trace.h"
+#include "incremental/incremental.h"
 #include<stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
 // For analyze_semantics
 
+#define WATCH_POLL_MS 200
+
+static void watch_sleep(unsigned ms) {
+#ifdef _WIN32
+    Sleep(ms);
+#else
+    usleep(ms * 1000);
+#endif
+}
+
+// Reports the program's first error, or writes output.asm if there is none
+static void finish_watch_build(const IncrementalSession* session, double elapsed) {
+    IncrementalDiagnostic diagnostic;
+    if (incremental_check(session, &diagnostic)) {
+        size_t line, column;
+        incremental_position(session, diagnostic.offset, &line, &column);
+        report_error_nonfatal(diagnostic.type, (int)line, (int)column, "%s", diagnostic.message);
+    } else {
+        FILE* asm_file = fopen("output.asm", "w");
+        if (!asm_file) {
+            perror("fopen failed");
+        } else {
+            if (!incremental_write_assembly(session, asm_file)) {
+                fprintf(stderr, "[ERROR] Out of memory during code generation.\n");
+            }
+            fclose(asm_file);
+        }
+    }
+    fprintf(stderr, "[watch] %.2f ms: re-lexed %zu bytes, re-parsed %zu of %zu definitions\n", elapsed * 1e3,
+            session->relexed_bytes, session->reparsed_units, session->count);
+}
+
+// --watch: compiles the file, then recompiles it whenever it is saved. Only
+// the top-level definitions an edit touched are lexed, parsed, checked and
+// compiled again; the rest are reused from the previous build.
+static int watch_file(const char* path) {
+    Lexer* file = create_lexer_from_file(path);
+    clock_t begin = clock();
+    IncrementalSession* session = incremental_open(file->input, file->length);
+    clock_t end = clock();
+    free_lexer(file);
+    if (!session) {
+        fprintf(stderr, "[ERROR] Out of memory during incremental compilation.\n");
+        return 1;
+    }
+    finish_watch_build(session, (double)(end - begin) / CLOCKS_PER_SEC);
+
+    struct stat info;
+    time_t modified = 0;
+    long long size = 0;
+    if (stat(path, &info) == 0) {
+        modified = info.st_mtime;
+        size = (long long)info.st_size;
+    }
+    for (;;) {
+        watch_sleep(WATCH_POLL_MS);
+        if (stat(path, &info) != 0 || (info.st_mtime == modified && (long long)info.st_size == size)) continue;
+        modified = info.st_mtime;
+        size = (long long)info.st_size;
+        file = create_lexer_from_file(path);
+        begin = clock();
+        int ok = incremental_update(session, file->input, file->length);
+        end = clock();
+        free_lexer(file);
+        if (!ok) {
+            fprintf(stderr, "[ERROR] Out of memory during incremental compilation.\n");
+            continue;
+        }
+        finish_watch_build(session, (double)(end - begin) / CLOCKS_PER_SEC);
+    }
+}
+
 int main(int argc, char* argv[]) {
     if (argc < 2) {
-        fprintf(stderr, "Usage: %s <input_file>\n", argv[0]);
+        fprintf(stderr, "Usage: %s [--watch | --lalr | --fused | --ast-codegen] <input_file | ->\n", argv[0]);
         return 1;
     }
 
-    Lexer* lexer = create_lexer_from_file(argv[1]);
+    // MINICC_TRACE=parser,sema enables categories compiled in with -DTRACE_CATEGORIES
+    const char* trace_spec = getenv("MINICC_TRACE");
+    if (trace_spec) trace_configure(trace_spec);
+
+    if (strcmp(argv[1], "--watch") == 0) {
+        if (argc < 3) {
+            fprintf(stderr, "Usage: %s --watch <input_file>\n", argv[0]);
+            return 1;
+        }
+        return watch_file(argv[2]);
+    }
+
+    // --lalr parses with the generated table-driven parser instead of the
+    // recursive-descent one; both build the same tree. --fused checks scopes
+    // and names while parsing instead of in a separate pass over the tree.
+    // --ast-codegen emits assembly straight from the tree instead of
+    // lowering the optimized IR.
+    const char* input = argv[1];
+    int use_lalr = strcmp(argv[1], "--lalr") == 0;
+    int fused = strcmp(argv[1], "--fused") == 0;
+    CodegenBackend backend = strcmp(argv[1], "--ast-codegen") == 0 ? CODEGEN_AST : CODEGEN_IR;
+    if (use_lalr || fused || backend == CODEGEN_AST) {
+        if (argc < 3) {
+            fprintf(stderr, "Usage: %s %s <input_file | ->\n", argv[0], argv[1]);
+            return 1;
+        }
+        input = argv[2];
+    }
+
+    // "-" streams the source from stdin in fixed-size chunks
+    Lexer* lexer = strcmp(input, "-") == 0 ? create_lexer_from_stream(stdin)
+                                           : create_lexer_from_file(input);
     if (!lexer) {
         fprintf(stderr, "Failed to open input file.\n");
         return 1;
     }
 
-    Parser* parser = create_parser(lexer);
-    if (!parser) {
+    // Diagnostics resolve node offsets to line/column through the lexer's index
+    set_error_source(&lexer->lines);
+
+    // Files are lexed up front into a token buffer (large ones on several
+    // threads); stdin, and files too large for the buffer's 32-bit offsets,
+    // are parsed straight from the lexer
+    TokenBuffer* tokens = NULL;
+    Parser* parser = NULL;
+    if (lexer->refill || lexer->length > UINT32_MAX) {
+        parser = create_parser(lexer);
+    } else if ((tokens = lexer_tokenize_parallel(lexer, 0, 0))) {
+        parser = create_parser_from_tokens(tokens);
+    }
+    if (!parser || (fused && !parser_enable_semantics(parser))) {
         fprintf(stderr, "Failed to create parser.\n");
+        free_parser(parser);
+        free_token_buffer(tokens);
         free_lexer(lexer);
         return 1;
     }
 
+    // The whole AST lives in one arena and is released in a single step
+    Arena* ast_arena = create_arena(0);
+    parser->arena = ast_arena;
+
     // Parse the program (use parse_program instead of parse)
-    ASTNode* root = parse_program(parser);
+    ASTNode* root = use_lalr ? parse_program_lalr(parser) : parse_program_parallel(parser, 0);
     if (!root) {
         fprintf(stderr, "Parsing failed.\n");
+        free_arena(ast_arena);
+        free_parser(parser);
+        free_token_buffer(tokens);
+        free_lexer(lexer);
+        return 1;
+    }
+
+    // Later phases walk the compact pool; the pointer tree is no longer needed
+    AstPool* pool = ast_pool_build(root);
+    free_arena(ast_arena);
+    if (!pool) {
+        fprintf(stderr, "[ERROR] Out of memory building the AST pool.\n");
         free_parser(parser);
+        free_token_buffer(tokens);
+        free_lexer(lexer);
         return 1;
     }
 
     // Remove debug and IR output to stdout, only emit assembly
-    analyze_semantics(root);
+    // Functions are checked and compiled independently, one per task, on a
+    // thread per CPU; output keeps source order. A fused parse has checked
+    // them already.
+    if (fused) {
+        report_semantic_results(pool, parser->sema_results, parser->sema_result_count);
+    } else {
+        analyze_semantics_pool(pool, 0);
+    }
     if (get_semantic_error()) {
         fprintf(stderr, "[ERROR] Semantic errors detected. Aborting code generation.\n");
-        free_ast(root);
+        free_ast_pool(pool);
         free_parser(parser);
+        free_token_buffer(tokens);
         free_lexer(lexer);
         return 1;
     }
     // Write assembly directly to output.asm
     FILE* asm_file = fopen("output.asm", "w");
     if (asm_file) {
-        AsmGenerator* gen = create_asm_generator(asm_file);
-        fprintf(asm_file, "section .data\n");
-        fprintf(asm_file, "__return_value dq 0\n");
-        fprintf(asm_file, "fmt db 'Result: %%lld', 10, 0\n");
-        SymbolEntry* current = symbol_table ? symbol_table->symbols : NULL;
-        while (current) {
-            fprintf(asm_file, "%s dq 0\n", current->name);
-            current = current->next;
-        }
-
-        // Do NOT emit a dq 0 for local variables a, b, etc.
-        fprintf(asm_file, "section .text\n");
-        fprintf(asm_file, "global main\n");
-        fprintf(asm_file, "extern printf\n");
-        fprintf(asm_file, "main:\n");
-        generate_assembly(gen, root);
-        // Print __return_value at the end if assigned
-        if (gen->has_return_value) {
-            fprintf(asm_file, "    mov rdx, qword [rel __return_value]\n");
-            fprintf(asm_file, "    lea rcx, [rel fmt]\n");
-            fprintf(asm_file, "    call printf\n");
+        generate_program_header(asm_file);
+        if (!generate_program_pool(asm_file, pool, 0, backend)) {
+            fprintf(stderr, "[ERROR] Out of memory during code generation.\n");
         }
-        fprintf(asm_file, "    ret\n");
-        free_asm_generator(gen);
         fclose(asm_file);
     } else {
         fprintf(stderr, "[ERROR] Could not open output.asm for writing.\n");
         perror("fopen failed");
     }
 
-    free_ast(root);
+    free_ast_pool(pool);
     free_parser(parser);
+    free_token_buffer(tokens);
     free_lexer(lexer);
-    if (symbol_table) free_symbol_table(symbol_table);
+    free_intern_table();
     return 0;
 }
@@ -4,153 +4,204 @@
 #include <stdio.h>
 #include "../lexer/token.h"
 
-#ifdef _WIN32
-#define strdup _strdup
-#endif
+static SourceLoc loc_of(const Token* token) {
+    SourceLoc loc = { token ? token->offset : SOURCE_OFFSET_NONE };
+    return loc;
+}
 
-ASTNode* create_number_node(int value, Token* token) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+static ASTNode* alloc_node(Arena* arena) {
+    ASTNode* node = arena ? arena_alloc(arena, sizeof(ASTNode)) : malloc(sizeof(ASTNode));
+    if (node) node->arena_owned = arena != NULL;
+    return node;
+}
+
+ASTNode* create_number_node(Arena* arena, int value, const Token* token) {
+    ASTNode* node = alloc_node(arena);
     if (!node) return NULL;
     node->type = AST_NUMBER;
     node->value = value;
-    node->token = token;
+    node->loc = loc_of(token);
     return node;
 }
 
-ASTNode* create_identifier_node(const char* name, Token* token) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+ASTNode* create_identifier_node(Arena* arena, Atom name, const Token* token) {
+    ASTNode* node = alloc_node(arena);
     if (!node) return NULL;
     node->type = AST_IDENTIFIER;
-    node->identifier = strdup(name);
-    node->token = token;
+    node->identifier = name;
+    node->identifier_slot = AST_SLOT_NONE;
+    node->loc = loc_of(token);
     return node;
 }
 
-ASTNode* create_binop_node(BinOpType op, ASTNode* left, ASTNode* right, Token* token) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+ASTNode* create_binop_node(Arena* arena, BinOpType op, ASTNode* left, ASTNode* right, const Token* token) {
+    ASTNode* node = alloc_node(arena);
     if (!node) return NULL;
     node->type = AST_BINARY_OP;
     node->binop.op_type = op;
     node->binop.left = left;
     node->binop.right = right;
-    node->token = token;
+    node->loc = loc_of(token);
     return node;
 }
 
-ASTNode* create_declaration_node(const char* name, ASTNode* init, Token* token) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+ASTNode* create_declaration_node(Arena* arena, Atom name, ASTNode* init, const Token* token) {
+    ASTNode* node = alloc_node(arena);
     if (!node) return NULL;
     node->type = AST_DECLARATION;
-    node->declaration.name = strdup(name);
+    node->declaration.name = name;
+    node->declaration.slot = AST_SLOT_NONE;
     node->declaration.init = init;
-    node->token = token;
+    node->loc = loc_of(token);
     return node;
 }
 
-ASTNode* create_assignment_node(const char* name, ASTNode* value, Token* token) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+ASTNode* create_assignment_node(Arena* arena, Atom name, ASTNode* value, const Token* token) {
+    ASTNode* node = alloc_node(arena);
     if (!node) return NULL;
     node->type = AST_ASSIGNMENT;
-    node->assignment.name = strdup(name);
+    node->assignment.name = name;
+    node->assignment.slot = AST_SLOT_NONE;
     node->assignment.value = value;
-    node->token = token;
+    node->loc = loc_of(token);
     return node;
 }
 
-ASTNode* create_compound_node(ASTNode** statements, size_t count) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+// Node with a copied child array, shared by blocks and programs
+static ASTNode* create_list_node(Arena* arena, ASTNodeType type, ASTNode* const* statements, size_t count) {
+    ASTNode* node = alloc_node(arena);
     if (!node) return NULL;
-    node->type = AST_BLOCK;
-    node->block.statements = statements;
+    size_t size = count * sizeof(ASTNode*);
+    ASTNode** copy = arena ? arena_alloc(arena, size) : malloc(size ? size : 1);
+    if (!copy) {
+        if (!arena) free(node);
+        return NULL;
+    }
+    if (size) memcpy(copy, statements, size);
+    node->type = type;
+    node->block.statements = copy;
     node->block.count = count;
-    node->token = NULL;
+    node->loc = loc_of(NULL);
     return node;
 }
 
-ASTNode* create_if_node(ASTNode* condition, ASTNode* then_branch, ASTNode* else_branch, Token* token) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+ASTNode* create_compound_node(Arena* arena, ASTNode* const* statements, size_t count) {
+    return create_list_node(arena, AST_BLOCK, statements, count);
+}
+
+ASTNode* create_program_node(Arena* arena, ASTNode* const* functions, size_t count) {
+    return create_list_node(arena, AST_PROGRAM, functions, count);
+}
+
+ASTNode* create_if_node(Arena* arena, ASTNode* condition, ASTNode* then_branch, ASTNode* else_branch, const Token* token) {
+    ASTNode* node = alloc_node(arena);
     if (!node) return NULL;
     node->type = AST_IF;
     node->if_stmt.condition = condition;
     node->if_stmt.then_branch = then_branch;
     node->if_stmt.else_branch = else_branch;
-    node->token = token;
+    node->loc = loc_of(token);
     return node;
 }
 
-ASTNode* create_while_node(ASTNode* condition, ASTNode* body, Token* token) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+ASTNode* create_while_node(Arena* arena, ASTNode* condition, ASTNode* body, const Token* token) {
+    ASTNode* node = alloc_node(arena);
     if (!node) return NULL;
     node->type = AST_WHILE;
     node->while_stmt.condition = condition;
     node->while_stmt.body = body;
-    node->token = token;
+    node->loc = loc_of(token);
     return node;
 }
 
-ASTNode* create_function_node(const char* name, ASTNode* body, Token* token) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+ASTNode* create_function_node(Arena* arena, Atom name, ASTNode* body, const Token* token) {
+    ASTNode* node = alloc_node(arena);
     if (!node) return NULL;
     node->type = AST_FUNCTION;
-    node->function.name = strdup(name);
+    node->function.name = name;
+    node->function.frame = AST_SLOT_NONE;
     node->function.body = body;
-    node->token = token;
+    node->loc = loc_of(token);
     return node;
 }
 
-ASTNode* create_return_node(ASTNode* expr, Token* token) {
-    ASTNode* node = malloc(sizeof(ASTNode));
+ASTNode* create_return_node(Arena* arena, ASTNode* expr, const Token* token) {
+    ASTNode* node = alloc_node(arena);
     if (!node) return NULL;
     node->type = AST_RETURN;
     node->return_stmt.expr = expr;
-    node->token = token;
+    node->loc = loc_of(token);
     return node;
 }
 
+// Pushes a child onto free_ast's work stack; heap nodes only
+static int push_pending(ASTNode*** stack, size_t* count, size_t* capacity, ASTNode* node) {
+    if (!node || node->arena_owned) return 1;
+    if (*count == *capacity) {
+        size_t grown_capacity = *capacity ? *capacity * 2 : 64;
+        ASTNode** grown = realloc(*stack, grown_capacity * sizeof(ASTNode*));
+        if (!grown) return 0;
+        *stack = grown;
+        *capacity = grown_capacity;
+    }
+    (*stack)[(*count)++] = node;
+    return 1;
+}
+
 void free_ast(ASTNode* node) {
-    if (!node) return;
+    // Arena nodes are released all at once by free_arena
+    if (!node || node->arena_owned) return;
 
-    switch (node->type) {
-        case AST_BLOCK:
-            for (size_t i = 0; i < node->block.count; ++i)
-                free_ast(node->block.statements[i]);
-            free(node->block.statements);
-            break;
-        case AST_COMPOUND:
-            for (size_t i = 0; i < node->block.count; ++i)
-                free_ast(node->block.statements[i]);
-            free(node->block.statements);
-            break;
-        case AST_IDENTIFIER:
-            free(node->identifier);
-            break;
-        case AST_BINARY_OP:
-            free_ast(node->binop.left);
-            free_ast(node->binop.right);
-            break;
-        case AST_DECLARATION:
-            free(node->declaration.name);
-            if (node->declaration.init)
-                free_ast(node->declaration.init);
-            break;
-        case AST_ASSIGNMENT:
-            free(node->assignment.name);
-            free_ast(node->assignment.value);
-            break;
-        case AST_NUMBER:
-            // No dynamic memory to free
-            break;
-        case AST_FUNCTION:
-            free(node->function.name);
-            free_ast(node->function.body);
-            break;
-        case AST_RETURN:
-            free_ast(node->return_stmt.expr);
-            break;
-        default:
-            break;
+    // Nodes are freed from an explicit work stack rather than by recursion,
+    // so arbitrarily deep trees use constant native stack
+    ASTNode** stack = NULL;
+    size_t count = 0, capacity = 0;
+    int ok = push_pending(&stack, &count, &capacity, node);
+    while (ok && count > 0) {
+        node = stack[--count];
+        switch (node->type) {
+            case AST_BLOCK:
+            case AST_COMPOUND:
+            case AST_PROGRAM:
+                for (size_t i = 0; ok && i < node->block.count; ++i)
+                    ok = push_pending(&stack, &count, &capacity, node->block.statements[i]);
+                free(node->block.statements);
+                break;
+            case AST_BINARY_OP:
+                ok = push_pending(&stack, &count, &capacity, node->binop.left) &&
+                     push_pending(&stack, &count, &capacity, node->binop.right);
+                break;
+            case AST_DECLARATION:
+                ok = push_pending(&stack, &count, &capacity, node->declaration.init);
+                break;
+            case AST_ASSIGNMENT:
+                ok = push_pending(&stack, &count, &capacity, node->assignment.value);
+                break;
+            case AST_NUMBER:
+                // No dynamic memory to free
+                break;
+            case AST_FUNCTION:
+                ok = push_pending(&stack, &count, &capacity, node->function.body);
+                break;
+            case AST_RETURN:
+                ok = push_pending(&stack, &count, &capacity, node->return_stmt.expr);
+                break;
+            case AST_IF:
+                ok = push_pending(&stack, &count, &capacity, node->if_stmt.condition) &&
+                     push_pending(&stack, &count, &capacity, node->if_stmt.then_branch) &&
+                     push_pending(&stack, &count, &capacity, node->if_stmt.else_branch);
+                break;
+            case AST_WHILE:
+                ok = push_pending(&stack, &count, &capacity, node->while_stmt.condition) &&
+                     push_pending(&stack, &count, &capacity, node->while_stmt.body);
+                break;
+            default:
+                break;
+        }
+        free(node);
     }
-    free(node);
+    if (!ok) fprintf(stderr, "[WARNING] free_ast: out of memory, part of the tree was not freed\n");
+    free(stack);
 }
 
 void print_ast(ASTNode* node, int indent) {
@@ -164,7 +215,7 @@ void print_ast(ASTNode* node, int indent) {
             fprintf(stderr, "%*sNUMBER: %d\n", indent+2, "", node->value);
             break;
         case AST_IDENTIFIER:
-            fprintf(stderr, "%*sIDENTIFIER: %s\n", indent+2, "", node->identifier);
+            fprintf(stderr, "%*sIDENTIFIER: %s\n", indent+2, "", atom_name(node->identifier));
             break;
         case AST_BINARY_OP:
             fprintf(stderr, "%*sBINARY_OP\n", indent+2, "");
@@ -172,13 +223,19 @@ void print_ast(ASTNode* node, int indent) {
             print_ast(node->binop.right, indent+4);
             break;
         case AST_ASSIGNMENT:
-            fprintf(stderr, "%*sASSIGNMENT: %s\n", indent+2, "", node->assignment.name);
+            fprintf(stderr, "%*sASSIGNMENT: %s\n", indent+2, "", atom_name(node->assignment.name));
             print_ast(node->assignment.value, indent+4);
             break;
         case AST_DECLARATION:
-            fprintf(stderr, "%*sDECLARATION: %s\n", indent+2, "", node->declaration.name);
+            fprintf(stderr, "%*sDECLARATION: %s\n", indent+2, "", atom_name(node->declaration.name));
             print_ast(node->declaration.init, indent+4);
             break;
+        case AST_PROGRAM:
+            fprintf(stderr, "%*sPROGRAM (%zu functions)\n", indent+2, "", node->block.count);
+            for (size_t i = 0; i < node->block.count; ++i) {
+                print_ast(node->block.statements[i], indent+4);
+            }
+            break;
         case AST_COMPOUND:
             fprintf(stderr, "%*sCOMPOUND (%zu statements)\n", indent+2, "", node->block.count);
             for (size_t i = 0; i < node->block.count; ++i) {
@@ -204,7 +261,7 @@ void print_ast(ASTNode* node, int indent) {
             print_ast(node->while_stmt.body, indent+6);
             break;
         case AST_FUNCTION:
-            fprintf(stderr, "%*sFUNCTION: %s\n", indent+2, "", node->function.name);
+            fprintf(stderr, "%*sFUNCTION: %s\n", indent+2, "", atom_name(node->function.name));
             fprintf(stderr, "%*sBODY:\n", indent+4, "");
             print_ast(node->function.body, indent+6);
             break;
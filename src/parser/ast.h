@@ -2,7 +2,10 @@
 #define AST_H
 
 #include <stddef.h>  // for size_t
+#include <stdint.h>
 #include "../lexer/token.h"
+#include "../utils/intern.h"
+#include "../utils/arena.h"
 typedef enum {
     AST_NUMBER,
     AST_IDENTIFIER,
@@ -14,7 +17,8 @@ typedef enum {
     AST_IF,
     AST_WHILE,
     AST_RETURN,
-    AST_FUNCTION
+    AST_FUNCTION,
+    AST_PROGRAM   // top-level function definitions, in source order
 } ASTNodeType;
 
 typedef enum {
@@ -32,16 +36,26 @@ typedef enum {
 
 struct Token;  // Forward declaration
 
+// Slot fields of nodes whose names are not bound yet. A fused parse
+// (parser_enable_semantics) binds them as it goes: a declaration, identifier
+// or assignment gets the frame slot of the variable it names, a function the
+// number of slots its frame needs.
+#define AST_SLOT_NONE UINT32_MAX
+
 typedef struct ASTNode {
     ASTNodeType type;
-    struct Token* token;
+    unsigned char arena_owned;  // allocated from an Arena; free_ast leaves it alone
+    SourceLoc loc;  // position of the node's leading token
 
     union {
         // For AST_NUMBER
         int value;
 
         // For AST_IDENTIFIER
-        char* identifier;
+        struct {
+            Atom identifier;
+            uint32_t identifier_slot;
+        };
 
         // For AST_BINARY_OP
         struct {
@@ -52,17 +66,19 @@ typedef struct ASTNode {
 
         // For AST_DECLARATION
         struct {
-            char* name;
+            Atom name;
+            uint32_t slot;
             struct ASTNode* init;
         } declaration;
 
         // For AST_ASSIGNMENT
         struct {
-            char* name;
+            Atom name;
+            uint32_t slot;
             struct ASTNode* value;
         } assignment;
 
-        // For AST_BLOCK (and legacy AST_COMPOUND)
+        // For AST_BLOCK (and legacy AST_COMPOUND); AST_PROGRAM lists functions
         struct {
             struct ASTNode** statements;
             size_t count;
@@ -88,23 +104,29 @@ typedef struct ASTNode {
 
         // For AST_FUNCTION
         struct {
-            char* name;
+            Atom name;
+            uint32_t frame;
             struct ASTNode* body;
         } function;
     };
 } ASTNode;
 
 // Function declarations
-ASTNode* create_number_node(int value, struct Token* token);
-ASTNode* create_identifier_node(const char* name, struct Token* token);
-ASTNode* create_binop_node(BinOpType op, ASTNode* left, ASTNode* right, struct Token* token);
-ASTNode* create_declaration_node(const char* name, ASTNode* init, struct Token* token);
-ASTNode* create_assignment_node(const char* name, ASTNode* value, struct Token* token);
-ASTNode* create_compound_node(ASTNode** statements, size_t count);
-ASTNode* create_if_node(ASTNode* condition, ASTNode* then_branch, ASTNode* else_branch, struct Token* token);
-ASTNode* create_while_node(ASTNode* condition, ASTNode* body, struct Token* token);
-ASTNode* create_return_node(struct ASTNode* expr, struct Token* token);
-ASTNode* create_function_node(const char* name, struct ASTNode* body, struct Token* token);
+// The token arguments only supply the source position and may be NULL.
+// Nodes (and block statement arrays) come from `arena` when it is non-NULL;
+// such a tree is released with free_arena, and free_ast ignores it. With a
+// NULL arena every node is malloc'd and the tree is released with free_ast.
+ASTNode* create_number_node(Arena* arena, int value, const struct Token* token);
+ASTNode* create_identifier_node(Arena* arena, Atom name, const struct Token* token);
+ASTNode* create_binop_node(Arena* arena, BinOpType op, ASTNode* left, ASTNode* right, const struct Token* token);
+ASTNode* create_declaration_node(Arena* arena, Atom name, ASTNode* init, const struct Token* token);
+ASTNode* create_assignment_node(Arena* arena, Atom name, ASTNode* value, const struct Token* token);
+ASTNode* create_compound_node(Arena* arena, ASTNode* const* statements, size_t count);  // copies the array
+ASTNode* create_if_node(Arena* arena, ASTNode* condition, ASTNode* then_branch, ASTNode* else_branch, const struct Token* token);
+ASTNode* create_while_node(Arena* arena, ASTNode* condition, ASTNode* body, const struct Token* token);
+ASTNode* create_return_node(Arena* arena, struct ASTNode* expr, const struct Token* token);
+ASTNode* create_function_node(Arena* arena, Atom name, struct ASTNode* body, const struct Token* token);
+ASTNode* create_program_node(Arena* arena, ASTNode* const* functions, size_t count);  // copies the array
 void free_ast(ASTNode* node);
 
 #endif // AST_H
@@ -0,0 +1,207 @@
+#include "ast_pool.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Reserves a node with `operands` operand words; returns AST_REF_NONE if out of memory
+static AstRef pool_reserve(AstPool* pool, const ASTNode* node, uint32_t aux, size_t operands) {
+    size_t words = AST_POOL_HEADER_WORDS + operands;
+    if (pool->count + words > UINT32_MAX) return AST_REF_NONE;
+    if (pool->count + words > pool->capacity) {
+        size_t capacity = pool->capacity * 2;
+        while (capacity < pool->count + words) capacity *= 2;
+        uint32_t* grown = realloc(pool->words, capacity * sizeof(uint32_t));
+        if (!grown) return AST_REF_NONE;
+        pool->words = grown;
+        pool->capacity = capacity;
+    }
+    AstRef ref = (AstRef)pool->count;
+    pool->count += words;
+    pool->nodes++;
+    pool->words[ref] = (uint32_t)node->type | aux << 8;
+    pool->words[ref + 1] = node->loc.offset < AST_POOL_OFFSET_NONE ? (uint32_t)node->loc.offset
+                                                                    : AST_POOL_OFFSET_NONE;
+    memset(pool->words + ref + AST_POOL_HEADER_WORDS, 0, operands * sizeof(uint32_t));  // absent children
+    return ref;
+}
+
+// Latest declaration copied for each frame slot of a tree a fused parse
+// bound. Nodes are laid out in source order, so this is the declaration a
+// use of the slot refers to.
+typedef struct SlotDecls {
+    AstRef* refs;
+    size_t capacity;
+} SlotDecls;
+
+static int bind_declaration(SlotDecls* decls, uint32_t slot, AstRef ref) {
+    if (slot == AST_SLOT_NONE) return 1;
+    if (slot >= decls->capacity) {
+        size_t capacity = decls->capacity ? decls->capacity * 2 : 64;
+        while (capacity <= slot) capacity *= 2;
+        AstRef* grown = realloc(decls->refs, capacity * sizeof(AstRef));
+        if (!grown) return 0;
+        memset(grown + decls->capacity, 0, (capacity - decls->capacity) * sizeof(AstRef));
+        decls->refs = grown;
+        decls->capacity = capacity;
+    }
+    decls->refs[slot] = ref;
+    return 1;
+}
+
+static AstRef bound_declaration(const SlotDecls* decls, uint32_t slot) {
+    return slot < decls->capacity ? decls->refs[slot] : AST_REF_NONE;
+}
+
+// A node waiting to be copied, and the operand of its parent to patch
+typedef struct PendingNode {
+    const ASTNode* node;
+    AstRef parent;
+    unsigned field;
+} PendingNode;
+
+typedef struct PendingStack {
+    PendingNode* items;
+    size_t count;
+    size_t capacity;
+} PendingStack;
+
+static int push_pending(PendingStack* stack, const ASTNode* node, AstRef parent, unsigned field) {
+    if (!node) return 1;  // absent children stay AST_REF_NONE
+    if (stack->count == stack->capacity) {
+        size_t capacity = stack->capacity ? stack->capacity * 2 : 256;
+        PendingNode* grown = realloc(stack->items, capacity * sizeof(PendingNode));
+        if (!grown) return 0;
+        stack->items = grown;
+        stack->capacity = capacity;
+    }
+    PendingNode* item = &stack->items[stack->count++];
+    item->node = node;
+    item->parent = parent;
+    item->field = field;
+    return 1;
+}
+
+// Appends one node with its scalar operands filled in and queues its
+// children, whose references are patched in when they are emitted. Children
+// are pushed last-first so they are popped, and so laid out, in visiting
+// order right after their parent.
+static int emit_node(AstPool* pool, PendingStack* stack, SlotDecls* decls, const ASTNode* node, AstRef* out) {
+    AstRef ref = AST_REF_NONE;
+    int ok = 1;
+    switch (node->type) {
+        case AST_NUMBER:
+            if ((ref = pool_reserve(pool, node, 0, 1))) ast_pool_set_field(pool, ref, 0, (uint32_t)node->value);
+            break;
+        case AST_IDENTIFIER:
+            if ((ref = pool_reserve(pool, node, 0, 2))) {
+                ast_pool_set_field(pool, ref, 0, node->identifier);
+                ast_pool_set_field(pool, ref, 1, bound_declaration(decls, node->identifier_slot));
+            }
+            break;
+        case AST_BINARY_OP:
+            if ((ref = pool_reserve(pool, node, node->binop.op_type, 2))) {
+                ok = push_pending(stack, node->binop.right, ref, 1) && push_pending(stack, node->binop.left, ref, 0);
+            }
+            break;
+        case AST_DECLARATION:
+            if ((ref = pool_reserve(pool, node, 0, 3))) {
+                ast_pool_set_field(pool, ref, 0, node->declaration.name);
+                ast_pool_set_field(pool, ref, 2, node->declaration.slot);
+                ok = bind_declaration(decls, node->declaration.slot, ref) &&
+                     push_pending(stack, node->declaration.init, ref, 1);
+            }
+            break;
+        case AST_ASSIGNMENT:
+            if ((ref = pool_reserve(pool, node, 0, 3))) {
+                ast_pool_set_field(pool, ref, 0, node->assignment.name);
+                ast_pool_set_field(pool, ref, 2, bound_declaration(decls, node->assignment.slot));
+                ok = push_pending(stack, node->assignment.value, ref, 1);
+            }
+            break;
+        case AST_BLOCK:
+        case AST_COMPOUND:
+        case AST_PROGRAM:
+            if (node->block.count >= UINT32_MAX) break;
+            if ((ref = pool_reserve(pool, node, 0, 1 + node->block.count))) {
+                ast_pool_set_field(pool, ref, 0, (uint32_t)node->block.count);
+                for (size_t i = node->block.count; ok && i-- > 0;) {
+                    ok = push_pending(stack, node->block.statements[i], ref, 1 + (unsigned)i);
+                }
+            }
+            break;
+        case AST_IF:
+            if ((ref = pool_reserve(pool, node, 0, 3))) {
+                ok = push_pending(stack, node->if_stmt.else_branch, ref, 2) &&
+                     push_pending(stack, node->if_stmt.then_branch, ref, 1) &&
+                     push_pending(stack, node->if_stmt.condition, ref, 0);
+            }
+            break;
+        case AST_WHILE:
+            if ((ref = pool_reserve(pool, node, 0, 2))) {
+                ok = push_pending(stack, node->while_stmt.body, ref, 1) &&
+                     push_pending(stack, node->while_stmt.condition, ref, 0);
+            }
+            break;
+        case AST_RETURN:
+            if ((ref = pool_reserve(pool, node, 0, 1))) {
+                ok = push_pending(stack, node->return_stmt.expr, ref, 0);
+            }
+            break;
+        case AST_FUNCTION:
+            if ((ref = pool_reserve(pool, node, 0, 3))) {
+                ast_pool_set_field(pool, ref, 0, node->function.name);
+                ast_pool_set_field(pool, ref, 2, node->function.frame == AST_SLOT_NONE ? 0 : node->function.frame);
+                ok = push_pending(stack, node->function.body, ref, 1);
+            }
+            break;
+        default:
+            // Unknown kinds keep their header so walkers can report them
+            ref = pool_reserve(pool, node, 0, 0);
+            break;
+    }
+    *out = ref;
+    return ok && ref != AST_REF_NONE;
+}
+
+AstPool* ast_pool_build(const ASTNode* root) {
+    AstPool* pool = malloc(sizeof(AstPool));
+    if (!pool) return NULL;
+    pool->capacity = 1024;
+    pool->words = malloc(pool->capacity * sizeof(uint32_t));
+    pool->count = 1;  // AST_REF_NONE
+    pool->nodes = 0;
+    pool->root = AST_REF_NONE;
+    if (!pool->words) {
+        free(pool);
+        return NULL;
+    }
+    pool->words[0] = 0;
+
+    // Pre-order copy driven by an explicit stack: tree depth costs heap, not native stack
+    PendingStack stack = { NULL, 0, 0 };
+    SlotDecls decls = { NULL, 0 };
+    int ok = push_pending(&stack, root, AST_REF_NONE, 0);
+    while (ok && stack.count > 0) {
+        PendingNode item = stack.items[--stack.count];
+        AstRef ref;
+        ok = emit_node(pool, &stack, &decls, item.node, &ref);
+        if (item.parent) {
+            ast_pool_set_field(pool, item.parent, item.field, ref);
+        } else {
+            pool->root = ref;
+        }
+    }
+    free(stack.items);
+    free(decls.refs);
+    if (!ok) {
+        free_ast_pool(pool);
+        return NULL;
+    }
+    return pool;
+}
+
+void free_ast_pool(AstPool* pool) {
+    if (pool) {
+        free(pool->words);
+        free(pool);
+    }
+}
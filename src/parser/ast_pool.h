@@ -0,0 +1,119 @@
+#ifndef AST_POOL_H
+#define AST_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ast.h"
+
+// Compact AST: every node lives in one contiguous array of 32-bit words and
+// is referenced by its word index. A node is a two-word header followed by
+// as many operand words as its kind needs:
+//
+//   word 0   kind | aux << 8      (aux is the BinOpType of AST_BINARY_OP)
+//   word 1   source offset        (AST_POOL_OFFSET_NONE if unknown)
+//
+//   AST_NUMBER        value
+//   AST_IDENTIFIER    atom decl
+//   AST_BINARY_OP     left right
+//   AST_DECLARATION   atom init slot
+//   AST_ASSIGNMENT    atom value decl
+//   AST_BLOCK         count statement...   (AST_COMPOUND likewise)
+//   AST_IF            condition then else
+//   AST_WHILE         condition body
+//   AST_RETURN        expr
+//   AST_FUNCTION      atom body frame
+//   AST_PROGRAM       count function...
+//
+// decl, slot and frame are the bindings, filled in by semantic analysis (or
+// copied from the tree, when a fused parse bound its names):
+// an identifier or assignment names the declaration it resolves to (the
+// declaration's ref is the symbol's ID), a declaration its frame slot, and
+// a function the number of frame slots it needs. Until then they are
+// AST_REF_NONE, AST_SLOT_NONE and 0. Later phases read the slot instead of
+// looking names up.
+//
+// Nodes are laid out in pre-order, children in the order the semantic
+// analyzer and code generator visit them, so a walk mostly reads memory
+// front to back. A number is 12 bytes here against a full ASTNode.
+typedef uint32_t AstRef;
+
+#define AST_REF_NONE 0  // word 0 is reserved; an absent child
+#define AST_POOL_HEADER_WORDS 2
+#define AST_POOL_OFFSET_NONE UINT32_MAX
+
+typedef struct AstPool {
+    uint32_t* words;
+    size_t count;     // words in use
+    size_t capacity;
+    size_t nodes;
+    AstRef root;
+} AstPool;
+
+// Copies a tree into a new pool. Returns NULL if out of memory.
+AstPool* ast_pool_build(const ASTNode* root);
+void free_ast_pool(AstPool* pool);
+
+static inline ASTNodeType ast_pool_kind(const AstPool* pool, AstRef ref) {
+    return (ASTNodeType)(pool->words[ref] & 0xFFu);
+}
+
+static inline BinOpType ast_pool_op(const AstPool* pool, AstRef ref) {
+    return (BinOpType)(pool->words[ref] >> 8);
+}
+
+static inline size_t ast_pool_offset(const AstPool* pool, AstRef ref) {
+    uint32_t offset = pool->words[ref + 1];
+    return offset == AST_POOL_OFFSET_NONE ? SOURCE_OFFSET_NONE : offset;
+}
+
+// Operand word i of a node, per the table above
+static inline uint32_t ast_pool_field(const AstPool* pool, AstRef ref, unsigned i) {
+    return pool->words[ref + AST_POOL_HEADER_WORDS + i];
+}
+
+static inline void ast_pool_set_field(AstPool* pool, AstRef ref, unsigned i, uint32_t value) {
+    pool->words[ref + AST_POOL_HEADER_WORDS + i] = value;
+}
+
+// Frame slot of the variable an identifier, declaration or assignment names
+static inline uint32_t ast_pool_slot(const AstPool* pool, AstRef ref) {
+    AstRef decl = ref;
+    switch (ast_pool_kind(pool, ref)) {
+        case AST_IDENTIFIER: decl = ast_pool_field(pool, ref, 1); break;
+        case AST_ASSIGNMENT: decl = ast_pool_field(pool, ref, 2); break;
+        case AST_DECLARATION: break;
+        default: return AST_SLOT_NONE;
+    }
+    return decl ? ast_pool_field(pool, decl, 2) : AST_SLOT_NONE;
+}
+
+// Statement i of an AST_BLOCK / AST_COMPOUND node, or function i of an AST_PROGRAM
+static inline AstRef ast_pool_statement(const AstPool* pool, AstRef ref, size_t i) {
+    return pool->words[ref + AST_POOL_HEADER_WORDS + 1 + i];
+}
+
+// Words taken by node `ref`; in pre-order the next node starts right after it
+static inline size_t ast_pool_node_words(const AstPool* pool, AstRef ref) {
+    switch (ast_pool_kind(pool, ref)) {
+        case AST_NUMBER:
+        case AST_RETURN:
+            return AST_POOL_HEADER_WORDS + 1;
+        case AST_IDENTIFIER:
+        case AST_BINARY_OP:
+        case AST_WHILE:
+            return AST_POOL_HEADER_WORDS + 2;
+        case AST_DECLARATION:
+        case AST_ASSIGNMENT:
+        case AST_IF:
+        case AST_FUNCTION:
+            return AST_POOL_HEADER_WORDS + 3;
+        case AST_BLOCK:
+        case AST_COMPOUND:
+        case AST_PROGRAM:
+            return AST_POOL_HEADER_WORDS + 1 + ast_pool_field(pool, ref, 0);
+        default:
+            return AST_POOL_HEADER_WORDS;
+    }
+}
+
+#endif // AST_POOL_H
@@ -1,26 +1,89 @@
 #include "parser.h"
 #include "ast.h"
 #include "../utils/symbol_table.h"
+#include "../utils/trace.h"
+#include "../utils/parallel.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <stdarg.h>
 
 #ifdef _WIN32
 #define strdup _strdup
 #endif
 
-static void advance(Parser* parser) {
-    parser->current_token = lexer_next_token(parser->lexer);
-    if (parser->current_token) {
-        fprintf(stderr, "[DEBUG] advance: token type=%d, value=%s\n",
-            parser->current_token->type,
-            parser->current_token->value ? parser->current_token->value : "(null)");
+// Makes sure at least k + 1 tokens are buffered in the ring
+static void fill_ring(Parser* parser, unsigned k) {
+    TokenRing* ring = &parser->ring;
+    Lexer* lexer = parser->lexer;
+    if (!lexer) {
+        while (ring->count <= k) {
+            unsigned slot = (ring->head + ring->count) & (PARSER_LOOKAHEAD - 1);
+            if (parser->next_token < parser->end_token) {
+                token_buffer_get(parser->tokens, parser->next_token++, &ring->slots[slot]);
+            } else {
+                // Past the end of a range: EOF at the position of the next token
+                token_buffer_get(parser->tokens, parser->end_token, &ring->slots[slot]);
+                ring->slots[slot].type = TOKEN_EOF;
+                ring->slots[slot].length = 0;
+            }
+            ring->count++;
+        }
+        return;
+    }
+    while (ring->count <= k) {
+        unsigned slot = (ring->head + ring->count) & (PARSER_LOOKAHEAD - 1);
+        // Keep the text of every buffered token alive across a streaming refill
+        lexer->retain = ring->count ? ring->slots[ring->head].offset : LEXER_RETAIN_NONE;
+        lexer_scan_token(lexer, &ring->slots[slot]);
+        ring->count++;
+    }
+    if (ring->window != lexer->input || ring->window_base != lexer->base) {
+        for (unsigned i = 0; i < ring->count; ++i) {
+            Token* token = &ring->slots[(ring->head + i) & (PARSER_LOOKAHEAD - 1)];
+            token->text = lexer->input + (token->offset - lexer->base);
+        }
+        ring->window = lexer->input;
+        ring->window_base = lexer->base;
+    }
+}
+
+// Reports a syntax error, unless the parse is speculative
+static void parse_error(Parser* parser, const char* format, ...) {
+    if (parser->quiet) return;
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+}
+
+Token* parser_peek_token(Parser* parser, unsigned k) {
+    if (k >= PARSER_LOOKAHEAD) {
+        fprintf(stderr, "Error: lookahead of %u tokens exceeds PARSER_LOOKAHEAD\n", k);
+        k = PARSER_LOOKAHEAD - 1;
     }
+    fill_ring(parser, k);
+    return &parser->ring.slots[(parser->ring.head + k) & (PARSER_LOOKAHEAD - 1)];
+}
+
+static void advance(Parser* parser) {
+    TokenRing* ring = &parser->ring;
+    ring->head = (ring->head + 1) & (PARSER_LOOKAHEAD - 1);
+    ring->count--;
+    fill_ring(parser, 0);
+    parser->current_token = &ring->slots[ring->head];
+    TRACE(TRACE_PARSER, "advance", "type=%d offset=%zu text=%.*s",
+          parser->current_token->type, parser->current_token->offset,
+          (int)parser->current_token->length, parser->current_token->text);
+}
+
+void parser_advance(Parser* parser) {
+    advance(parser);
 }
 
 // Grammar rules for C-like language:
 //
-// program           : function_definition
+// program           : function_definition { function_definition }
 // function_definition: type IDENTIFIER '(' ')' compound_statement
 // block             : '{' { statement } '}'
 // statement         : declaration | assignment | if_statement | while_statement | return_statement | block
@@ -29,12 +92,10 @@ static void advance(Parser* parser) {
 // if_statement      : 'if' '(' expression ')' statement [ 'else' statement ]
 // while_statement   : 'while' '(' expression ')' statement
 // return_statement  : 'return' expression ';'
-// expression        : ... (handled by parse_expression)
+// expression        : factor { binary_op factor }   (precedence: see binary_operators)
 
 // Forward declarations
 static ASTNode* parse_expression(Parser* parser);
-static ASTNode* parse_term(Parser* parser);
-static ASTNode* parse_additive(Parser* parser);
 static ASTNode* parse_factor(Parser* parser);
 static ASTNode* parse_declaration(Parser* parser);
 static ASTNode* parse_assignment(Parser* parser);
@@ -42,32 +103,99 @@ static ASTNode* parse_statement(Parser* parser);
 static ASTNode* parse_block(Parser* parser);
 static ASTNode* parse_if(Parser* parser);
 static ASTNode* parse_while(Parser* parser);
-static ASTNode* parse_comparison(Parser* parser);
 static ASTNode* parse_function_definition(Parser* parser, const char* name);
 
-// Parser symbol table
-// static SymbolTable* parser_symbol_table = NULL;
-
 Parser* create_parser(Lexer* lexer) {
     Parser* parser = malloc(sizeof(Parser));
     if (!parser) return NULL;
     parser->lexer = lexer;
-    parser->current_token = lexer_next_token(lexer);
-    if (parser->current_token) {
-        fprintf(stderr, "[DEBUG] create_parser: first token type=%d, value=%s\n",
-            parser->current_token->type,
-            parser->current_token->value ? parser->current_token->value : "(null)");
-    }
-    // No local parser_symbol_table, rely on global symbol_table
+    parser->tokens = NULL;
+    parser->next_token = 0;
+    parser->end_token = 0;
+    parser->arena = NULL;
+    parser->stmt_stack = NULL;
+    parser->stmt_count = 0;
+    parser->stmt_capacity = 0;
+    parser->names = create_symbol_table(NULL);
+    parser->quiet = 0;
+    parser->sema = NULL;
+    parser->sema_results = NULL;
+    parser->sema_result_count = 0;
+    parser->sema_result_capacity = 0;
+    parser->ring.head = 0;
+    parser->ring.count = 0;
+    parser->ring.window = lexer->input;
+    parser->ring.window_base = lexer->base;
+    parser->current_token = parser_peek_token(parser, 0);
+    TRACE(TRACE_PARSER, "start", "type=%d offset=%zu text=%.*s",
+          parser->current_token->type, parser->current_token->offset,
+          (int)parser->current_token->length, parser->current_token->text);
+    return parser;
+}
+
+Parser* create_parser_from_tokens(const TokenBuffer* tokens) {
+    if (!tokens || tokens->count == 0) return NULL;
+    return create_parser_from_token_range(tokens, 0, tokens->count - 1);
+}
+
+Parser* create_parser_from_token_range(const TokenBuffer* tokens, size_t begin, size_t end) {
+    if (!tokens || tokens->count == 0 || begin > end || end >= tokens->count) return NULL;
+    Parser* parser = malloc(sizeof(Parser));
+    if (!parser) return NULL;
+    parser->lexer = NULL;
+    parser->tokens = tokens;
+    parser->next_token = begin;
+    parser->end_token = end;
+    parser->arena = NULL;
+    parser->stmt_stack = NULL;
+    parser->stmt_count = 0;
+    parser->stmt_capacity = 0;
+    parser->names = create_symbol_table(NULL);
+    parser->quiet = 0;
+    parser->sema = NULL;
+    parser->sema_results = NULL;
+    parser->sema_result_count = 0;
+    parser->sema_result_capacity = 0;
+    parser->ring.head = 0;
+    parser->ring.count = 0;
+    parser->ring.window = tokens->source;
+    parser->ring.window_base = 0;
+    parser->current_token = parser_peek_token(parser, 0);
     return parser;
 }
 
 void free_parser(Parser* parser) {
     if (parser) {
+        free(parser->stmt_stack);
+        if (parser->names) free_symbol_table(parser->names);
+        if (parser->sema) semantic_scope_free(parser->sema);
+        free(parser->sema);
+        free(parser->sema_results);
         free(parser);
     }
 }
 
+int parser_enable_semantics(Parser* parser) {
+    if (!parser->sema) {
+        parser->sema = malloc(sizeof(SemanticScope));
+        if (!parser->sema) return 0;
+        semantic_scope_init(parser->sema);
+    }
+    return 1;
+}
+
+// Result slot for the next function of a fused parse; NULL if out of memory
+static SemanticResult* next_sema_result(Parser* parser) {
+    if (parser->sema_result_count == parser->sema_result_capacity) {
+        size_t capacity = parser->sema_result_capacity ? parser->sema_result_capacity * 2 : 16;
+        SemanticResult* grown = realloc(parser->sema_results, capacity * sizeof(SemanticResult));
+        if (!grown) return NULL;
+        parser->sema_results = grown;
+        parser->sema_result_capacity = capacity;
+    }
+    return &parser->sema_results[parser->sema_result_count];
+}
+
 static ASTNode* parse_factor(Parser* parser) {
     Token* tok = parser->current_token;
     if (!tok) return NULL;
@@ -75,29 +203,33 @@ static ASTNode* parse_factor(Parser* parser) {
     if (tok->type == TOKEN_RETURN) {
         return NULL;
     }
-    fprintf(stderr, "[DEBUG] parse_factor: token type=%d, value=%s\n",
-        tok->type, tok->value ? tok->value : "(null)");
+    TRACE(TRACE_PARSER, "factor", "type=%d offset=%zu text=%.*s",
+          tok->type, tok->offset, (int)tok->length, tok->text);
 
     if (tok->type == TOKEN_NUMBER) {
-        int value = atoi(tok->value);
+        ASTNode* node = create_number_node(parser->arena, tok->number, tok);
         advance(parser);
-        return create_number_node(value, tok);
+        return node;
     } else if (tok->type == TOKEN_IDENTIFIER) {
-        char* name = strdup(tok->value);
-        // Check if identifier is declared
-        if (!lookup_symbol(symbol_table, name)) {
-            fprintf(stderr, "[ERROR] Variable '%s' used before declaration (parse_factor)\n", name);
-            free(name);
+        Atom name = tok->atom;
+        uint32_t slot = AST_SLOT_NONE;
+        if (parser->sema) {
+            slot = semantic_use(parser->sema, name, 0, tok->offset, NULL);
+        } else if (!lookup_symbol(parser->names, name)) {
+            // Check if identifier is declared
+            parse_error(parser, "[ERROR] Variable '%s' used before declaration (parse_factor)\n", atom_name(name));
             return NULL;
         }
+        ASTNode* node = create_identifier_node(parser->arena, name, tok);
+        if (node) node->identifier_slot = slot;
         advance(parser);
-        return create_identifier_node(name, tok);
+        return node;
     } else if (tok->type == TOKEN_LPAREN) {
         advance(parser);
         ASTNode* expr = parse_expression(parser);
         if (!expr) return NULL;
         if (!parser->current_token || parser->current_token->type != TOKEN_RPAREN) {
-            fprintf(stderr, "Error: Expected ')'\n");
+            parse_error(parser, "Error: Expected ')'\n");
             free_ast(expr);
             return NULL;
         }
@@ -105,156 +237,139 @@ static ASTNode* parse_factor(Parser* parser) {
         return expr;
     }
 
-    fprintf(stderr, "Error: Unexpected token in factor\n");
+    parse_error(parser, "Error: Unexpected token in factor\n");
     return NULL;
 }
 
-static ASTNode* parse_term(Parser* parser) {
-    ASTNode* node = parse_factor(parser);
-    if (!node) return NULL;
-    while (parser->current_token &&
-          (parser->current_token->type == TOKEN_MUL || parser->current_token->type == TOKEN_DIV)) {
-        BinOpType op = (parser->current_token->type == TOKEN_MUL) ? OP_MUL : OP_DIV;
-        Token* tok = parser->current_token;
-        advance(parser);
-        ASTNode* right = parse_factor(parser);
-        if (!right) {
-            free_ast(node);
-            return NULL;
-        }
-        node = create_binop_node(op, node, right, tok);
-    }
-    return node;
+// Binary operators by token type. Binding power orders the precedence
+// levels (higher binds tighter); 0 means the token is not a binary operator.
+// All operators are left-associative.
+typedef struct {
+    unsigned char power;
+    BinOpType op;
+} BinaryOperator;
+
+enum {
+    BP_NONE = 0,
+    BP_COMPARISON = 10,
+    BP_ADDITIVE = 20,
+    BP_MULTIPLICATIVE = 30
+};
+
+static const BinaryOperator binary_operators[] = {
+    [TOKEN_LT]    = { BP_COMPARISON, OP_LT },
+    [TOKEN_GT]    = { BP_COMPARISON, OP_GT },
+    [TOKEN_LE]    = { BP_COMPARISON, OP_LE },
+    [TOKEN_GE]    = { BP_COMPARISON, OP_GE },
+    [TOKEN_EQ]    = { BP_COMPARISON, OP_EQ },
+    [TOKEN_NEQ]   = { BP_COMPARISON, OP_NEQ },
+    [TOKEN_PLUS]  = { BP_ADDITIVE, OP_ADD },
+    [TOKEN_MINUS] = { BP_ADDITIVE, OP_SUB },
+    [TOKEN_MUL]   = { BP_MULTIPLICATIVE, OP_MUL },
+    [TOKEN_DIV]   = { BP_MULTIPLICATIVE, OP_DIV },
+};
+
+static const BinaryOperator* binary_operator(const Token* tok) {
+    if (!tok || (size_t)tok->type >= sizeof(binary_operators) / sizeof(binary_operators[0])) return NULL;
+    const BinaryOperator* info = &binary_operators[tok->type];
+    return info->power ? info : NULL;
 }
 
-static ASTNode* parse_additive(Parser* parser) {
-    ASTNode* node = parse_term(parser);
-    if (!node) return NULL;
-    while (parser->current_token &&
-          (parser->current_token->type == TOKEN_PLUS || parser->current_token->type == TOKEN_MINUS)) {
-        BinOpType op = (parser->current_token->type == TOKEN_PLUS) ? OP_ADD : OP_SUB;
-        Token* tok = parser->current_token;
-        advance(parser);
-        ASTNode* right = parse_term(parser);
-        if (!right) {
-            free_ast(node);
-            return NULL;
-        }
-        node = create_binop_node(op, node, right, tok);
-    }
-    return node;
-}
-
-static ASTNode* parse_comparison(Parser* parser) {
-    ASTNode* node = parse_additive(parser);
+// Precedence climbing: parses operators that bind tighter than `min_power`.
+// Runs of equal precedence are folded left in the loop, so recursion only
+// happens when precedence rises or on parentheses.
+static ASTNode* parse_binary(Parser* parser, unsigned min_power) {
+    ASTNode* node = parse_factor(parser);
     if (!node) return NULL;
-    while (parser->current_token && (
-            parser->current_token->type == TOKEN_LT ||
-            parser->current_token->type == TOKEN_GT ||
-            parser->current_token->type == TOKEN_LE ||
-            parser->current_token->type == TOKEN_GE ||
-            parser->current_token->type == TOKEN_EQ ||
-            parser->current_token->type == TOKEN_NEQ)) {
-        BinOpType op;
-        switch (parser->current_token->type) {
-            case TOKEN_LT: op = OP_LT; break;
-            case TOKEN_GT: op = OP_GT; break;
-            case TOKEN_LE: op = OP_LE; break;
-            case TOKEN_GE: op = OP_GE; break;
-            case TOKEN_EQ: op = OP_EQ; break;
-            case TOKEN_NEQ: op = OP_NEQ; break;
-            default: op = OP_ADD; break; // fallback
-        }
-        Token* tok = parser->current_token;
+    const BinaryOperator* info;
+    while ((info = binary_operator(parser->current_token)) && info->power > min_power) {
+        Token op_token = *parser->current_token;
         advance(parser);
-        ASTNode* right = parse_additive(parser);
+        ASTNode* right = parse_binary(parser, info->power);
         if (!right) {
             free_ast(node);
             return NULL;
         }
-        node = create_binop_node(op, node, right, tok);
+        node = create_binop_node(parser->arena, info->op, node, right, &op_token);
     }
     return node;
 }
 
 static ASTNode* parse_expression(Parser* parser) {
-    return parse_comparison(parser);
+    return parse_binary(parser, BP_NONE);
 }
 
 static ASTNode* parse_declaration(Parser* parser) {
     // Expect: int identifier [= expr] ;
     if (parser->current_token->type != TOKEN_INT) {
-        fprintf(stderr, "Expected 'int' keyword in declaration\n");
+        parse_error(parser, "Expected 'int' keyword in declaration\n");
         return NULL;
     }
-    Token* type_token = parser->current_token;
     advance(parser); // consume 'int'
     if (!parser->current_token || parser->current_token->type != TOKEN_IDENTIFIER) {
-        fprintf(stderr, "Expected identifier after 'int'\n");
+        parse_error(parser, "Expected identifier after 'int'\n");
         return NULL;
     }
-    char* name = strdup(parser->current_token->value);
-    Token* id_token = parser->current_token;
+    Atom name = parser->current_token->atom;
+    Token id_token = *parser->current_token;
     advance(parser); // consume identifier
+    // The analyzer declares a name before checking its initializer
+    uint32_t slot = parser->sema ? semantic_declare(parser->sema, name, 0, id_token.offset) : AST_SLOT_NONE;
     ASTNode* init_expr = NULL;
     if (parser->current_token && parser->current_token->type == TOKEN_ASSIGN) {
         advance(parser); // consume '='
         init_expr = parse_expression(parser);
         if (!init_expr) {
-            free(name);
             return NULL;
         }
     }
-    // Add variable to global symbol table
-    add_symbol(name);
-    return create_declaration_node(name, init_expr, id_token);
+    if (!parser->sema) add_symbol(parser->names, name);
+    ASTNode* decl = create_declaration_node(parser->arena, name, init_expr, &id_token);
+    if (decl) decl->declaration.slot = slot;
+    return decl;
 }
 
 static ASTNode* parse_assignment(Parser* parser) {
     if (parser->current_token->type != TOKEN_IDENTIFIER) {
-        fprintf(stderr, "Expected identifier in assignment\n");
+        parse_error(parser, "Expected identifier in assignment\n");
         return NULL;
     }
-    char* name = strdup(parser->current_token->value);
-    Token* tok = parser->current_token;
+    Atom name = parser->current_token->atom;
+    Token tok = *parser->current_token;
     advance(parser);
     if (!parser->current_token || parser->current_token->type != TOKEN_ASSIGN) {
-        fprintf(stderr, "Expected '=' in assignment\n");
-        free(name);
+        parse_error(parser, "Expected '=' in assignment\n");
         return NULL;
     }
     advance(parser);
-    fprintf(stderr, "[DEBUG] parse_assignment: before parse_expression, token type=%d, value=%s\n",
-        parser->current_token ? parser->current_token->type : -1,
-        parser->current_token && parser->current_token->value ? parser->current_token->value : "(null)");
+    TRACE(TRACE_PARSER, "assignment", "name=%s offset=%zu", atom_name(tok.atom), tok.offset);
+    uint32_t slot = parser->sema ? semantic_use(parser->sema, name, 1, tok.offset, NULL) : AST_SLOT_NONE;
     ASTNode* expr = parse_expression(parser);
-    fprintf(stderr, "[DEBUG] parse_assignment: after parse_expression, token type=%d, value=%s\n",
-        parser->current_token ? parser->current_token->type : -1,
-        parser->current_token && parser->current_token->value ? parser->current_token->value : "(null)");
     if (!expr) {
-        free(name);
         return NULL;
     }
-    return create_assignment_node(name, expr, tok);
+    ASTNode* assign = create_assignment_node(parser->arena, name, expr, &tok);
+    if (assign) assign->assignment.slot = slot;
+    return assign;
 }
 
 static ASTNode* parse_if(Parser* parser) {
     // Expect: if '(' expr ')' statement [else statement]
     if (parser->current_token->type != TOKEN_IF) {
-        fprintf(stderr, "Expected 'if'\n");
+        parse_error(parser, "Expected 'if'\n");
         return NULL;
     }
-    Token* if_token = parser->current_token;
+    Token if_token = *parser->current_token;
     advance(parser);
     if (!parser->current_token || parser->current_token->type != TOKEN_LPAREN) {
-        fprintf(stderr, "Expected '('\n");
+        parse_error(parser, "Expected '('\n");
         return NULL;
     }
     advance(parser);
     ASTNode* condition = parse_expression(parser);
     if (!condition) return NULL;
     if (!parser->current_token || parser->current_token->type != TOKEN_RPAREN) {
-        fprintf(stderr, "Expected ')'\n");
+        parse_error(parser, "Expected ')'\n");
         free_ast(condition);
         return NULL;
     }
@@ -274,26 +389,26 @@ static ASTNode* parse_if(Parser* parser) {
             return NULL;
         }
     }
-    return create_if_node(condition, then_branch, else_branch, if_token);
+    return create_if_node(parser->arena, condition, then_branch, else_branch, &if_token);
 }
 
 static ASTNode* parse_while(Parser* parser) {
     // Expect: while '(' expr ')' statement
     if (parser->current_token->type != TOKEN_WHILE) {
-        fprintf(stderr, "Expected 'while'\n");
+        parse_error(parser, "Expected 'while'\n");
         return NULL;
     }
-    Token* while_token = parser->current_token;
+    Token while_token = *parser->current_token;
     advance(parser);
     if (!parser->current_token || parser->current_token->type != TOKEN_LPAREN) {
-        fprintf(stderr, "Expected '('\n");
+        parse_error(parser, "Expected '('\n");
         return NULL;
     }
     advance(parser);
     ASTNode* condition = parse_expression(parser);
     if (!condition) return NULL;
     if (!parser->current_token || parser->current_token->type != TOKEN_RPAREN) {
-        fprintf(stderr, "Expected ')'\n");
+        parse_error(parser, "Expected ')'\n");
         free_ast(condition);
         return NULL;
     }
@@ -303,64 +418,77 @@ static ASTNode* parse_while(Parser* parser) {
         free_ast(condition);
         return NULL;
     }
-    return create_while_node(condition, body, while_token);
+    return create_while_node(parser->arena, condition, body, &while_token);
 }
 
 static ASTNode* parse_return(Parser* parser) {
     if (parser->current_token->type != TOKEN_RETURN) {
-        fprintf(stderr, "Expected 'return'\n");
+        parse_error(parser, "Expected 'return'\n");
         return NULL;
     }
-    Token* ret_token = parser->current_token;
+    Token ret_token = *parser->current_token;
     advance(parser);
+    if (parser->sema) parser->sema->found_return = 1;
     ASTNode* expr = parse_expression(parser);
     if (!expr) return NULL;
-    return create_return_node(expr, ret_token);
+    return create_return_node(parser->arena, expr, &ret_token);
+}
+
+// Frees the statements a failed block pushed and pops them off the stack
+static void drop_statements(Parser* parser, size_t base) {
+    for (size_t i = base; i < parser->stmt_count; ++i) free_ast(parser->stmt_stack[i]);
+    parser->stmt_count = base;
+}
+
+int parser_push_statement(Parser* parser, ASTNode* stmt) {
+    if (parser->stmt_count == parser->stmt_capacity) {
+        size_t capacity = parser->stmt_capacity ? parser->stmt_capacity * 2 : 64;
+        ASTNode** grown = realloc(parser->stmt_stack, capacity * sizeof(ASTNode*));
+        if (!grown) return 0;
+        parser->stmt_stack = grown;
+        parser->stmt_capacity = capacity;
+    }
+    parser->stmt_stack[parser->stmt_count++] = stmt;
+    return 1;
 }
 
 static ASTNode* parse_block(Parser* parser) {
     // Expect '{' { statement } '}'
     if (!parser->current_token || parser->current_token->type != TOKEN_LBRACE) {
-        fprintf(stderr, "Expected '{'\n");
+        parse_error(parser, "Expected '{'\n");
         return NULL;
     }
     advance(parser);
+    // A failed parse leaves the scope open; the next function drops it
+    if (parser->sema) semantic_open_block(parser->sema);
 
-    ASTNode** statements = NULL;
-    size_t capacity = 4;
-    size_t count = 0;
-    statements = malloc(sizeof(ASTNode*) * capacity);
-
+    // Statements are collected on the parser's shared stack (nested blocks
+    // push above `base`) and copied into an exactly-sized array at the end
+    size_t base = parser->stmt_count;
     while (parser->current_token && parser->current_token->type != TOKEN_RBRACE) {
         ASTNode* stmt = parse_statement(parser);
         if (!stmt) {
-            for (size_t i = 0; i < count; ++i) free_ast(statements[i]);
-            free(statements);
+            drop_statements(parser, base);
             return NULL;
         }
-        if (count >= capacity) {
-            capacity *= 2;
-            ASTNode** new_stmts = realloc(statements, sizeof(ASTNode*) * capacity);
-            if (!new_stmts) {
-                for (size_t i = 0; i < count; ++i) free_ast(statements[i]);
-                free(statements);
-                return NULL;
-            }
-            statements = new_stmts;
+        if (!parser_push_statement(parser, stmt)) {
+            free_ast(stmt);
+            drop_statements(parser, base);
+            return NULL;
         }
-        statements[count++] = stmt;
     }
 
     if (!parser->current_token || parser->current_token->type != TOKEN_RBRACE) {
-        fprintf(stderr, "Expected '}'\n");
-        for (size_t i = 0; i < count; i++) free_ast(statements[i]);
-        free(statements);
+        parse_error(parser, "Expected '}'\n");
+        drop_statements(parser, base);
         return NULL;
     }
     advance(parser);
+    if (parser->sema) semantic_close_block(parser->sema);
 
-    ASTNode* block = create_compound_node(statements, count);
-    free(statements);
+    ASTNode* block = create_compound_node(parser->arena, parser->stmt_stack + base, parser->stmt_count - base);
+    if (!block) drop_statements(parser, base);
+    parser->stmt_count = base;
     return block;
 }
 
@@ -373,7 +501,7 @@ static ASTNode* parse_statement(Parser* parser) {
                 ASTNode* decl = parse_declaration(parser);
                 if (!decl) return NULL;
                 if (!parser->current_token || parser->current_token->type != TOKEN_SEMICOLON) {
-                    fprintf(stderr, "Expected ';' after declaration\n");
+                    parse_error(parser, "Expected ';' after declaration\n");
                     free_ast(decl);
                     return NULL;
                 }
@@ -385,7 +513,7 @@ static ASTNode* parse_statement(Parser* parser) {
                 ASTNode* assign = parse_assignment(parser);
                 if (!assign) return NULL;
                 if (!parser->current_token || parser->current_token->type != TOKEN_SEMICOLON) {
-                    fprintf(stderr, "Expected ';' after assignment\n");
+                    parse_error(parser, "Expected ';' after assignment\n");
                     free_ast(assign);
                     return NULL;
                 }
@@ -401,7 +529,7 @@ static ASTNode* parse_statement(Parser* parser) {
                 ASTNode* ret = parse_return(parser);
                 if (!ret) return NULL;
                 if (!parser->current_token || parser->current_token->type != TOKEN_SEMICOLON) {
-                    fprintf(stderr, "Expected ';' after return\n");
+                    parse_error(parser, "Expected ';' after return\n");
                     free_ast(ret);
                     return NULL;
                 }
@@ -411,7 +539,7 @@ static ASTNode* parse_statement(Parser* parser) {
         case TOKEN_LBRACE:
             return parse_block(parser);
         default:
-            fprintf(stderr, "Unexpected token in statement: %d\n", parser->current_token->type);
+            parse_error(parser, "Unexpected token in statement: %d\n", parser->current_token->type);
             return NULL;
     }
 }
@@ -419,37 +547,216 @@ static ASTNode* parse_statement(Parser* parser) {
 static ASTNode* parse_function_definition(Parser* parser, const char* name) {
     // Expect: int identifier '(' ')' block
     if (parser->current_token->type != TOKEN_INT) {
-        fprintf(stderr, "Expected 'int' at function definition\n");
+        parse_error(parser, "Expected 'int' at function definition\n");
         return NULL;
     }
-    Token* type_token = parser->current_token;
+    Token type_token = *parser->current_token;
     advance(parser);
 
     if (parser->current_token->type != TOKEN_IDENTIFIER) {
-        fprintf(stderr, "Expected function name\n");
+        parse_error(parser, "Expected function name\n");
         return NULL;
     }
-    const char* func_name = parser->current_token->value;
+    Atom func_name = parser->current_token->atom;
     advance(parser);
 
     if (parser->current_token->type != TOKEN_LPAREN) {
-        fprintf(stderr, "Expected '('\n");
+        parse_error(parser, "Expected '('\n");
         return NULL;
     }
     advance(parser);
 
     if (parser->current_token->type != TOKEN_RPAREN) {
-        fprintf(stderr, "Expected ')'\n");
+        parse_error(parser, "Expected ')'\n");
         return NULL;
     }
     advance(parser);
 
+    if (parser->sema) {
+        SemanticResult* result = next_sema_result(parser);
+        if (!result) return NULL;
+        semantic_begin_function(parser->sema, result);
+    }
     ASTNode* body = parse_block(parser);
     if (!body) return NULL;
 
-    return create_function_node(func_name, body, type_token);
+    ASTNode* function = create_function_node(parser->arena, func_name, body, &type_token);
+    if (function && parser->sema) {
+        function->function.frame = semantic_end_function(parser->sema, type_token.offset);
+        parser->sema_result_count++;
+    }
+    return function;
 }
 
+// program: function_definition { function_definition } EOF
 ASTNode* parse_program(Parser* parser) {
-    return parse_function_definition(parser, NULL);
+    // Functions are collected on the statement stack like a block's statements
+    size_t base = parser->stmt_count;
+    size_t result_base = parser->sema_result_count;
+    do {
+        ASTNode* function = parse_function_definition(parser, NULL);
+        if (!function) {
+            drop_statements(parser, base);
+            parser->sema_result_count = result_base;
+            return NULL;
+        }
+        if (!parser_push_statement(parser, function)) {
+            free_ast(function);
+            drop_statements(parser, base);
+            parser->sema_result_count = result_base;
+            return NULL;
+        }
+    } while (parser->current_token && parser->current_token->type != TOKEN_EOF);
+
+    ASTNode* program = create_program_node(parser->arena, parser->stmt_stack + base, parser->stmt_count - base);
+    if (!program) {
+        drop_statements(parser, base);
+        parser->sema_result_count = result_base;
+    }
+    parser->stmt_count = base;
+    return program;
+}
+
+// A run of whole top-level definitions, parsed on its own by a worker
+typedef struct {
+    size_t begin;  // token range [begin, end)
+    size_t end;
+    Arena* arena;
+    ASTNode* program;    // NULL if the run did not parse
+    SymbolTable* names;  // declared in the run
+    SemanticResult* results;  // fused mode: one per function of the run
+} DefinitionRun;
+
+typedef struct {
+    const TokenBuffer* tokens;
+    DefinitionRun* runs;
+    int fused;
+} ParallelParse;
+
+static void parse_run_task(void* context, size_t index) {
+    ParallelParse* job = context;
+    DefinitionRun* run = &job->runs[index];
+    Parser* parser = create_parser_from_token_range(job->tokens, run->begin, run->end);
+    run->arena = create_arena(0);
+    if (parser && run->arena && (!job->fused || parser_enable_semantics(parser))) {
+        parser->quiet = 1;
+        parser->arena = run->arena;
+        run->program = parse_program(parser);
+        run->names = parser->names;
+        parser->names = NULL;
+        run->results = parser->sema_results;
+        parser->sema_results = NULL;
+    }
+    free_parser(parser);
+}
+
+// Cuts the tokens into runs at the closing braces that return to the top
+// level, once a run holds PARSER_PARALLEL_MIN_TOKENS tokens. Only braces are
+// looked at: a cut in the wrong place just makes a run fail to parse.
+// Returns the number of runs in *out (0 if out of memory).
+static size_t split_definitions(const TokenBuffer* tokens, DefinitionRun** out) {
+    size_t end = tokens->count - 1;  // the trailing TOKEN_EOF
+    size_t count = 0, capacity = 0, begin = 0, depth = 0;
+    DefinitionRun* runs = NULL;
+    for (size_t i = 0; i <= end; ++i) {
+        int cut = i == end;
+        if (tokens->types[i] == TOKEN_LBRACE) {
+            depth++;
+        } else if (tokens->types[i] == TOKEN_RBRACE && depth > 0) {
+            cut = --depth == 0 && i + 1 - begin >= PARSER_PARALLEL_MIN_TOKENS;
+        }
+        if (!cut) continue;
+        size_t stop = i == end ? end : i + 1;
+        if (count > 0 && stop - begin < PARSER_PARALLEL_MIN_TOKENS) {
+            runs[count - 1].end = stop;  // a short tail joins the previous run
+        } else if (stop > begin || count == 0) {
+            if (count == capacity) {
+                capacity = capacity ? capacity * 2 : 64;
+                DefinitionRun* grown = realloc(runs, capacity * sizeof(DefinitionRun));
+                if (!grown) {
+                    free(runs);
+                    return 0;
+                }
+                runs = grown;
+            }
+            DefinitionRun run = { begin, stop, NULL, NULL, NULL, NULL };
+            runs[count++] = run;
+        }
+        begin = stop;
+    }
+    *out = runs;
+    return count;
+}
+
+// Adds the names `from` declared to `into` in declaration order, as if
+// `into` had seen the declarations itself; `from` is left reversed
+static void merge_names(SymbolTable* into, SymbolTable* from) {
+    SymbolEntry* oldest_first = NULL;
+    while (from->symbols) {
+        SymbolEntry* entry = from->symbols;
+        from->symbols = entry->next;
+        entry->next = oldest_first;
+        oldest_first = entry;
+    }
+    from->symbols = oldest_first;
+    for (SymbolEntry* entry = oldest_first; entry; entry = entry->next) add_symbol(into, entry->name);
+}
+
+ASTNode* parse_program_parallel(Parser* parser, int threads) {
+    if (threads <= 0) threads = parallel_cpu_count();
+    if (!parser->tokens || !parser->arena || threads == 1) return parse_program(parser);
+
+    DefinitionRun* runs = NULL;
+    size_t count = split_definitions(parser->tokens, &runs);
+    if (count < 2) {
+        free(runs);
+        return parse_program(parser);
+    }
+    ParallelParse job = { parser->tokens, runs, parser->sema != NULL };
+    parallel_for(count, threads, parse_run_task, &job);
+
+    // Join the runs' functions (and in fused mode their results) into one
+    // program, in source order
+    int ok = 1;
+    size_t base = parser->stmt_count;
+    size_t result_base = parser->sema_result_count;
+    for (size_t i = 0; ok && i < count; ++i) {
+        ok = runs[i].program != NULL;
+        for (size_t f = 0; ok && f < runs[i].program->block.count; ++f) {
+            ok = parser_push_statement(parser, runs[i].program->block.statements[f]);
+            SemanticResult* result = ok && parser->sema ? next_sema_result(parser) : NULL;
+            if (result) {
+                *result = runs[i].results[f];
+                parser->sema_result_count++;
+            } else if (parser->sema) {
+                ok = 0;
+            }
+        }
+    }
+    if (!ok) parser->sema_result_count = result_base;
+    ASTNode* program = ok ? create_program_node(parser->arena, parser->stmt_stack + base, parser->stmt_count - base)
+                          : NULL;
+    parser->stmt_count = base;
+
+    for (size_t i = 0; i < count; ++i) {
+        if (program) {
+            arena_merge(parser->arena, runs[i].arena);
+            runs[i].arena = NULL;
+            merge_names(parser->names, runs[i].names);
+        }
+        free_arena(runs[i].arena);
+        if (runs[i].names) free_symbol_table(runs[i].names);
+        free(runs[i].results);
+    }
+    free(runs);
+    if (!program) {
+        // Speculation failed: parse again in order, reporting any error
+        return parse_program(parser);
+    }
+
+    // Leave the parser at the end of the input, as parse_program does
+    parser->next_token = parser->end_token;
+    parser->ring.count = 0;
+    parser->current_token = parser_peek_token(parser, 0);
+    return program;
 }
@@ -2,18 +2,93 @@
 #define PARSER_H
 
 #include "../lexer/lexer.h"
+#include "../lexer/token_buffer.h"
 #include "ast.h"
+#include "../utils/symbol_table.h"
+#include "../semantic/semantic_analyzer.h"
 
+// Lookahead ring between the lexer and the parser. Tokens are lexed exactly
+// once, by value, into a fixed set of slots; peeking k tokens ahead is an
+// index computation. A slot is reused PARSER_LOOKAHEAD tokens after it was
+// consumed, so anything kept past an advance must be copied out of it.
+#define PARSER_LOOKAHEAD 8  // power of two; supports peeking up to 7 tokens past the current one
+
+typedef struct TokenRing {
+    Token slots[PARSER_LOOKAHEAD];
+    unsigned head;   // slot of the current token
+    unsigned count;  // buffered tokens, including the current one
+    // Streaming lexers slide their window; buffered token texts are
+    // re-pointed whenever the window moved since the last fill.
+    const char* window;
+    size_t window_base;
+} TokenRing;
+
+// The parser pulls tokens either from a lexer, one at a time, or from a
+// pre-lexed TokenBuffer (exactly one of `lexer` and `tokens` is set).
 typedef struct Parser {
     Lexer* lexer;
-    Token* current_token;
+    const TokenBuffer* tokens;
+    size_t next_token;     // index of the next buffered token to load into the ring
+    size_t end_token;      // buffered tokens from here on read as TOKEN_EOF
+    Token* current_token;  // always &ring.slots[ring.head]
+    TokenRing ring;
+    // AST nodes are allocated from `arena` when it is set (the caller owns
+    // it and releases the tree with free_arena), otherwise from the heap.
+    Arena* arena;
+    ASTNode** stmt_stack;  // statements of the blocks being parsed
+    size_t stmt_count;
+    size_t stmt_capacity;
+    // Variables declared so far, in the parser's own table: a name must be
+    // declared (anywhere earlier in the input) before it is used
+    SymbolTable* names;
+    int quiet;  // set for speculative parses, whose errors are not reported
+    // Fused mode (parser_enable_semantics): scopes and names are checked and
+    // bound to frame slots while parsing, instead of against `names`, with
+    // one result per function parsed, in source order
+    SemanticScope* sema;
+    SemanticResult* sema_results;
+    size_t sema_result_count;
+    size_t sema_result_capacity;
 } Parser;
 
 // Now create_parser takes Lexer* pointer as argument
 Parser* create_parser(Lexer* lexer);
+// Parses a batch-lexed token stream; the buffer must outlive the parser
+Parser* create_parser_from_tokens(const TokenBuffer* tokens);
+// Parses tokens [begin, end) of a buffer, followed by TOKEN_EOF
+Parser* create_parser_from_token_range(const TokenBuffer* tokens, size_t begin, size_t end);
+
+// Switches the parser to fused mode: the checks analyze_semantics_pool makes
+// run during the parse, with the same diagnostics, and the tree comes out
+// with its names bound (see AST_SLOT_NONE), so no separate analysis walk is
+// needed; report the results with report_semantic_results. A use of an
+// undeclared name is then a semantic error, not a syntax error. Only the
+// recursive-descent parser supports it. Returns 0 if out of memory.
+int parser_enable_semantics(Parser* parser);
+
+// Token k positions after the current one (k == 0 is the current token)
+Token* parser_peek_token(Parser* parser, unsigned k);
+
+// Consumes the current token
+void parser_advance(Parser* parser);
+// Pushes a finished statement onto stmt_stack; returns 0 if it cannot grow
+int parser_push_statement(Parser* parser, ASTNode* stmt);
 
 ASTNode* parse(Parser* parser);
 ASTNode* parse_program(Parser* parser);
+// Same result as parse_program on a new, arena-backed token buffer parser.
+// A brace-matching pass first splits the tokens into runs of top-level
+// definitions, which are parsed on up to `threads` threads (<= 0 selects one
+// per CPU), each into its own arena; the arenas are then merged into the
+// parser's. If any run fails to parse, for instance because it uses a name
+// declared in an earlier run, the whole input is parsed again sequentially,
+// which reports the error exactly as parse_program does.
+#define PARSER_PARALLEL_MIN_TOKENS (1 << 14)  // fewest tokens in a run
+ASTNode* parse_program_parallel(Parser* parser, int threads);
+// Same contract and trees as parse_program, using the table-driven LALR(1)
+// parser generated from parser.y; nesting depth is not limited by the
+// native stack
+ASTNode* parse_program_lalr(Parser* parser);
 void free_parser(Parser* parser);
 
 #endif // PARSER_H
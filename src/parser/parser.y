@@ -1,159 +1,219 @@
+// Table-driven LALR(1) parser for the same language as the hand-written
+// recursive-descent parser in parser.c, producing identical ASTNode trees
+// (node kinds, source offsets, arena use) and the same symbol table checks.
+// Tokens come from the Parser's lexer or token buffer, so both parsers share
+// one lexer and one Parser object; pick one with parse_program or
+// parse_program_lalr.
+//
+// parser_lalr.c is generated from this file and checked in, so building the
+// compiler does not need bison. After editing the grammar, regenerate it
+// from the repository root with:
+//
+//     bison -o src/parser/parser_lalr.c src/parser/parser.y
+
+%code requires {
+#include "parser.h"
+}
 
-```flex:c%3A%5CUsers%5Cchauh%5Cmini%20compiler%5Clexer.l
-%{
+%code {
+#include "../utils/symbol_table.h"
 #include <stdio.h>
-#include <stdlib.h>
-#include "parser.tab.h"
-#include "error_handler.h"
 
-int line_number = 1;
-int column = 1;
-%}
+// The parse stacks live on the heap, so nesting is bounded by this limit
+// rather than by the native stack
+#define YYMAXDEPTH 1000000
 
-%%
-[ \t]           { column += yyleng; }
-[\n]            { line_number++; column = 1; }
-
-"int"           { column += yyleng; return INT; }
-"if"            { column += yyleng; return IF; }
-"else"          { column += yyleng; return ELSE; }
-"while"         { column += yyleng; return WHILE; }
-"return"        { column += yyleng; return RETURN; }
-
-[a-zA-Z_][a-zA-Z0-9_]*  { 
-    column += yyleng;
-    yylval.string = strdup(yytext);
-    return IDENTIFIER;
+static int lalr_lex(LALR_STYPE* value, Parser* parser);
+static void lalr_error(Parser* parser, const char* message);
 }
 
-[0-9]+          {
-    column += yyleng;
-    yylval.number = atoi(yytext);
-    return NUMBER;
-}
+%define api.prefix {lalr_}
+%define api.pure full
+%define parse.error verbose
+%param {Parser* parser}
+%expect 0
 
-"+"             { column += yyleng; return '+'; }
-"-"             { column += yyleng; return '-'; }
-"*"             { column += yyleng; return '*'; }
-"/"             { column += yyleng; return '/'; }
-"="             { column += yyleng; return '='; }
-"=="            { column += yyleng; return EQ; }
-"!="            { column += yyleng; return NE; }
-"<"             { column += yyleng; return '<'; }
-">"             { column += yyleng; return '>'; }
-"<="            { column += yyleng; return LE; }
-">="            { column += yyleng; return GE; }
-
-"{"             { column += yyleng; return '{'; }
-"}"             { column += yyleng; return '}'; }
-"("             { column += yyleng; return '('; }
-")"             { column += yyleng; return ')'; }
-";"             { column += yyleng; return ';'; }
-
-.               { 
-    report_error(line_number, column, "Invalid character: %s", yytext);
+%union {
+    Token token;   // terminals keep their token, for the node locations
+    ASTNode* node;
+    size_t base;   // index of a list's first entry on the statement stack
 }
 
-%%
+%token <token> NUMBER "number" IDENTIFIER "identifier"
+%token <token> INT "int" IF "if" ELSE "else" WHILE "while" RETURN "return"
+%token <token> ASSIGN "=" SEMICOLON ";" LPAREN "(" RPAREN ")" LBRACE "{" RBRACE "}"
+%token <token> PLUS "+" MINUS "-" MUL "*" DIV "/"
+%token <token> LT "<" GT ">" LE "<=" GE ">=" EQ "==" NEQ "!="
 
-int yywrap() {
-    return 1;
-}%{
-#include <stdio.h>
-#include <stdlib.h>
-#include "ast.h"
-#include "error_handler.h"
+%type <node> function_definition block statement expression
+%type <base> function_list statement_list
 
-extern int line_number;
-extern int column;
-extern int yylex();
-void yyerror(const char *s);
+%destructor { free_ast($$); } <node>
 
-ASTNode *root = NULL;
-%}
+// Same levels as the binding powers in parser.c; all left-associative
+%left LT GT LE GE EQ NEQ
+%left PLUS MINUS
+%left MUL DIV
 
-%union {
-    int number;
-    char *string;
-    struct ASTNode *node;
-}
-
-%token <number> NUMBER
-%token <string> IDENTIFIER
-%token INT IF ELSE WHILE RETURN
-%token EQ NE LE GE
-
-%type <node> program declaration statement expression
-%type <node> compound_statement statement_list
+// An else belongs to the nearest if
+%precedence THEN
+%precedence ELSE
 
 %%
 
+// program: function_definition { function_definition } EOF
 program
-    : declaration                { root = $1; }
+    : function_list {
+        // The functions are replaced by the program, for parse_program_lalr
+        ASTNode* program = create_program_node(parser->arena, parser->stmt_stack + $1, parser->stmt_count - $1);
+        if (!program) YYNOMEM;
+        parser->stmt_count = $1;
+        parser_push_statement(parser, program);
+    }
     ;
 
-declaration
-    : INT IDENTIFIER '(' ')' compound_statement
-        {
-            $$ = create_function_node($2, $5);
-            free($2);
+// Functions are collected on the statement stack like a block's statements
+function_list
+    : function_definition {
+        $$ = parser->stmt_count;
+        if (!parser_push_statement(parser, $1)) {
+            free_ast($1);
+            YYNOMEM;
+        }
+    }
+    | function_list function_definition {
+        $$ = $1;
+        if (!parser_push_statement(parser, $2)) {
+            free_ast($2);
+            YYNOMEM;
         }
+    }
     ;
 
-compound_statement
-    : '{' statement_list '}'    { $$ = $2; }
-    | '{' '}'                   { $$ = create_compound_statement(NULL); }
+function_definition
+    : INT IDENTIFIER LPAREN RPAREN block { $$ = create_function_node(parser->arena, $2.atom, $5, &$1); }
+    ;
+
+// Nested blocks push above `base` and pop back down to it when reduced
+block
+    : LBRACE statement_list RBRACE {
+        $$ = create_compound_node(parser->arena, parser->stmt_stack + $2, parser->stmt_count - $2);
+        if (!$$) YYNOMEM;
+        parser->stmt_count = $2;
+    }
     ;
 
 statement_list
-    : statement                 { $$ = create_compound_statement($1); }
-    | statement_list statement  { $$ = add_statement($1, $2); }
+    : %empty { $$ = parser->stmt_count; }
+    | statement_list statement {
+        $$ = $1;
+        if (!parser_push_statement(parser, $2)) {
+            free_ast($2);
+            YYNOMEM;
+        }
+    }
     ;
 
 statement
-    : expression ';'            { $$ = $1; }
-    | INT IDENTIFIER ';'        
-        {
-            $$ = create_var_declaration($2);
-            free($2);
-        }
-    | IDENTIFIER '=' expression ';'
-        {
-            $$ = create_assignment($1, $3);
-            free($1);
-        }
-    | IF '(' expression ')' statement
-        { $$ = create_if_statement($3, $5, NULL); }
-    | IF '(' expression ')' statement ELSE statement
-        { $$ = create_if_statement($3, $5, $7); }
-    | WHILE '(' expression ')' statement
-        { $$ = create_while_statement($3, $5); }
-    | RETURN expression ';'     { $$ = create_return_statement($2); }
-    | compound_statement        { $$ = $1; }
+    : INT IDENTIFIER SEMICOLON {
+        add_symbol(parser->names, $2.atom);
+        $$ = create_declaration_node(parser->arena, $2.atom, NULL, &$2);
+    }
+    | INT IDENTIFIER ASSIGN expression SEMICOLON {
+        // Declared only after its initializer, as in parse_declaration
+        add_symbol(parser->names, $2.atom);
+        $$ = create_declaration_node(parser->arena, $2.atom, $4, &$2);
+    }
+    | IDENTIFIER ASSIGN expression SEMICOLON { $$ = create_assignment_node(parser->arena, $1.atom, $3, &$1); }
+    | IF LPAREN expression RPAREN statement %prec THEN {
+        $$ = create_if_node(parser->arena, $3, $5, NULL, &$1);
+    }
+    | IF LPAREN expression RPAREN statement ELSE statement {
+        $$ = create_if_node(parser->arena, $3, $5, $7, &$1);
+    }
+    | WHILE LPAREN expression RPAREN statement { $$ = create_while_node(parser->arena, $3, $5, &$1); }
+    | RETURN expression SEMICOLON { $$ = create_return_node(parser->arena, $2, &$1); }
+    | block
     ;
 
 expression
-    : NUMBER                    { $$ = create_number_node($1); }
-    | IDENTIFIER               
-        {
-            $$ = create_identifier_node($1);
-            free($1);
+    : NUMBER { $$ = create_number_node(parser->arena, $1.number, &$1); }
+    | IDENTIFIER {
+        if (!lookup_symbol(parser->names, $1.atom)) {
+            fprintf(stderr, "[ERROR] Variable '%s' used before declaration (parse_factor)\n", atom_name($1.atom));
+            YYABORT;
         }
-    | expression '+' expression { $$ = create_binary_op('+', $1, $3); }
-    | expression '-' expression { $$ = create_binary_op('-', $1, $3); }
-    | expression '*' expression { $$ = create_binary_op('*', $1, $3); }
-    | expression '/' expression { $$ = create_binary_op('/', $1, $3); }
-    | expression EQ expression  { $$ = create_binary_op(EQ, $1, $3); }
-    | expression NE expression  { $$ = create_binary_op(NE, $1, $3); }
-    | expression '<' expression { $$ = create_binary_op('<', $1, $3); }
-    | expression '>' expression { $$ = create_binary_op('>', $1, $3); }
-    | expression LE expression  { $$ = create_binary_op(LE, $1, $3); }
-    | expression GE expression  { $$ = create_binary_op(GE, $1, $3); }
-    | '(' expression ')'        { $$ = $2; }
+        $$ = create_identifier_node(parser->arena, $1.atom, &$1);
+    }
+    | LPAREN expression RPAREN { $$ = $2; }
+    | expression LT expression { $$ = create_binop_node(parser->arena, OP_LT, $1, $3, &$2); }
+    | expression GT expression { $$ = create_binop_node(parser->arena, OP_GT, $1, $3, &$2); }
+    | expression LE expression { $$ = create_binop_node(parser->arena, OP_LE, $1, $3, &$2); }
+    | expression GE expression { $$ = create_binop_node(parser->arena, OP_GE, $1, $3, &$2); }
+    | expression EQ expression { $$ = create_binop_node(parser->arena, OP_EQ, $1, $3, &$2); }
+    | expression NEQ expression { $$ = create_binop_node(parser->arena, OP_NEQ, $1, $3, &$2); }
+    | expression PLUS expression { $$ = create_binop_node(parser->arena, OP_ADD, $1, $3, &$2); }
+    | expression MINUS expression { $$ = create_binop_node(parser->arena, OP_SUB, $1, $3, &$2); }
+    | expression MUL expression { $$ = create_binop_node(parser->arena, OP_MUL, $1, $3, &$2); }
+    | expression DIV expression { $$ = create_binop_node(parser->arena, OP_DIV, $1, $3, &$2); }
     ;
 
 %%
 
-void yyerror(const char *s) {
-    report_error(line_number, column, "%s", s);
-}
\ No newline at end of file
+// Grammar symbol of each lexer token type
+static const int token_kinds[] = {
+    [TOKEN_EOF]         = LALR_EOF,
+    [TOKEN_NUMBER]      = NUMBER,
+    [TOKEN_IDENTIFIER]  = IDENTIFIER,
+    [TOKEN_PLUS]        = PLUS,
+    [TOKEN_MINUS]       = MINUS,
+    [TOKEN_MUL]         = MUL,
+    [TOKEN_DIV]         = DIV,
+    [TOKEN_ASSIGN]      = ASSIGN,
+    [TOKEN_SEMICOLON]   = SEMICOLON,
+    [TOKEN_LPAREN]      = LPAREN,
+    [TOKEN_RPAREN]      = RPAREN,
+    [TOKEN_LBRACE]      = LBRACE,
+    [TOKEN_RBRACE]      = RBRACE,
+    [TOKEN_IF]          = IF,
+    [TOKEN_ELSE]        = ELSE,
+    [TOKEN_WHILE]       = WHILE,
+    [TOKEN_RETURN]      = RETURN,
+    [TOKEN_INT]         = INT,
+    [TOKEN_PUNCTUATION] = LALR_UNDEF,
+    [TOKEN_ERROR]       = LALR_UNDEF,
+    [TOKEN_OPERATOR]    = LALR_UNDEF,
+    [TOKEN_LT]          = LT,
+    [TOKEN_GT]          = GT,
+    [TOKEN_LE]          = LE,
+    [TOKEN_GE]          = GE,
+    [TOKEN_EQ]          = EQ,
+    [TOKEN_NEQ]         = NEQ,
+};
+
+// Hands the parser's current token to the automaton and moves past it
+static int lalr_lex(LALR_STYPE* value, Parser* parser) {
+    value->token = *parser->current_token;
+    TokenType type = value->token.type;
+    if (type == TOKEN_EOF) return LALR_EOF;
+    parser_advance(parser);
+    if ((size_t)type >= sizeof(token_kinds) / sizeof(token_kinds[0])) return LALR_UNDEF;
+    return token_kinds[type];
+}
+
+static void lalr_error(Parser* parser, const char* message) {
+    (void)parser;
+    fprintf(stderr, "Error: %s\n", message);
+}
+
+ASTNode* parse_program_lalr(Parser* parser) {
+    size_t base = parser->stmt_count;
+    if (lalr_parse(parser) != 0) {
+        // Statements of the blocks that were open when parsing stopped
+        for (size_t i = base; i < parser->stmt_count; ++i) free_ast(parser->stmt_stack[i]);
+        parser->stmt_count = base;
+        return NULL;
+    }
+    parser->stmt_count = base;
+    return parser->stmt_stack[base];
+}
@@ -1,141 +1,293 @@
 #include "../parser/ast.h"
+#include "../parser/ast_pool.h"
 #include "semantic_analyzer.h"
 #include "../utils/symbol_table.h"
+#include "../utils/scoped_table.h"
 #include "../utils/error_handler.h"
+#include "../utils/trace.h"
+#include "../utils/parallel.h"
+#include <stdarg.h>
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 
 static int semantic_error = 0;
 
-// Symbol table entry with type
-typedef struct VarEntry {
-    char* name;
-    int type; // Only int supported for now
-    struct VarEntry* next;
-} VarEntry;
-
-typedef struct Scope {
-    VarEntry* vars;
-    struct Scope* parent;
-} Scope;
-
-static Scope* scope_push(Scope* parent) {
-    Scope* s = malloc(sizeof(Scope));
-    s->vars = NULL;
-    s->parent = parent;
-    return s;
-}
-
-static void scope_pop(Scope* s) {
-    VarEntry* v = s->vars;
-    while (v) {
-        VarEntry* next = v->next;
-        free(v->name);
-        free(v);
-        v = next;
+// Records a diagnostic. Only the first one per function is reported (the
+// error handler stops at the first error), so later ones are just counted.
+static void sema_error(SemanticResult* result, ErrorType type, size_t offset, const char* format, ...) {
+    if (result->errors++ == 0) {
+        result->first_type = type;
+        result->first_offset = offset;
+        va_list args;
+        va_start(args, format);
+        vsnprintf(result->first_message, sizeof(result->first_message), format, args);
+        va_end(args);
     }
-    free(s);
 }
 
-static int scope_insert(Scope* s, const char* name, int type) {
-    for (VarEntry* v = s->vars; v; v = v->next) {
-        if (strcmp(v->name, name) == 0) return 0; // redeclaration
+void semantic_scope_init(SemanticScope* scope) {
+    scoped_table_init(&scope->table);
+    scope->result = NULL;
+    scope->found_return = 0;
+    scope->out_of_memory = 0;
+}
+
+void semantic_scope_free(SemanticScope* scope) {
+    scoped_table_free(&scope->table);
+}
+
+void semantic_begin_function(SemanticScope* scope, SemanticResult* result) {
+    while (scope->table.depth > 0) scoped_table_pop(&scope->table);
+    scope->table.binding_peak = 0;
+    scope->result = result;
+    scope->found_return = 0;
+    scope->out_of_memory = !scoped_table_push(&scope->table);
+    result->errors = 0;
+}
+
+uint32_t semantic_end_function(SemanticScope* scope, size_t offset) {
+    if (scope->out_of_memory) {
+        sema_error(scope->result, ERROR_SEMANTIC, offset, "Out of memory during semantic analysis");
+    } else if (!scope->found_return) {
+        sema_error(scope->result, ERROR_SEMANTIC, offset, "Missing return statement in function");
     }
-    VarEntry* v = malloc(sizeof(VarEntry));
-    v->name = strdup(name);
-    v->type = type;
-    v->next = s->vars;
-    s->vars = v;
-    return 1;
+    while (scope->table.depth > 0) scoped_table_pop(&scope->table);
+    return (uint32_t)scope->table.binding_peak;
 }
 
-static int scope_lookup(Scope* s, const char* name) {
-    for (Scope* cur = s; cur; cur = cur->parent) {
-        for (VarEntry* v = cur->vars; v; v = v->next) {
-            if (strcmp(v->name, name) == 0) return 1;
-        }
+void semantic_open_block(SemanticScope* scope) {
+    if (!scope->out_of_memory && !scoped_table_push(&scope->table)) scope->out_of_memory = 1;
+}
+
+void semantic_close_block(SemanticScope* scope) {
+    if (!scope->out_of_memory) scoped_table_pop(&scope->table);
+}
+
+uint32_t semantic_declare(SemanticScope* scope, Atom name, uint32_t value, size_t offset) {
+    if (scope->out_of_memory) return AST_SLOT_NONE;
+    int inserted = scoped_table_insert(&scope->table, name, value);
+    if (inserted < 0) {
+        scope->out_of_memory = 1;
+        return AST_SLOT_NONE;
+    }
+    if (!inserted) {
+        sema_error(scope->result, ERROR_REDEFINITION, offset, "Redeclaration of variable '%s'", atom_name(name));
+        return AST_SLOT_NONE;
+    }
+    return (uint32_t)(scope->table.binding_count - 1);
+}
+
+uint32_t semantic_use(SemanticScope* scope, Atom name, int assignment, size_t offset, uint32_t* value) {
+    if (scope->out_of_memory) return AST_SLOT_NONE;
+    const ScopedBinding* binding = scoped_table_lookup(&scope->table, name);
+    if (!binding) {
+        sema_error(scope->result, ERROR_UNDEFINED_VAR, offset, assignment ? "Assignment to undeclared variable '%s'"
+                                                                            : "Use of undeclared variable '%s'",
+                   atom_name(name));
+        return AST_SLOT_NONE;
+    }
+    if (value) *value = binding->value;
+    return (uint32_t)(binding - scope->table.bindings);
+}
+
+// Work item of the analyzer's explicit stack. Items run in source order, so
+// the innermost open scope of the table is always the one `ref` is in.
+typedef enum {
+    SEMA_VISIT,         // check `ref`
+    SEMA_POP_SCOPE,     // leave the scope of a block
+    SEMA_END_FUNCTION   // `ref`'s body is done: check for a return, leave its scope
+} SemaAction;
+
+typedef struct SemaItem {
+    AstRef ref;
+    SemaAction action;
+} SemaItem;
+
+typedef struct SemaStack {
+    SemaItem* items;
+    size_t count;
+    size_t capacity;
+} SemaStack;
+
+static int sema_push(SemaStack* stack, SemaAction action, AstRef ref) {
+    if (action == SEMA_VISIT && !ref) return 1;
+    if (stack->count == stack->capacity) {
+        size_t capacity = stack->capacity ? stack->capacity * 2 : 256;
+        SemaItem* grown = realloc(stack->items, capacity * sizeof(SemaItem));
+        if (!grown) return 0;
+        stack->items = grown;
+        stack->capacity = capacity;
     }
-    return 0;
+    stack->items[stack->count].ref = ref;
+    stack->items[stack->count].action = action;
+    stack->count++;
+    return 1;
 }
 
-static void analyze_node(ASTNode* node, Scope* scope, int* found_return) {
-    if (!node) return;
-    switch (node->type) {
+// Checks one node, binds the names it declares or uses, and queues its
+// children, last-first, so nodes are checked in source order. Returns 0 if
+// the work stack cannot grow.
+static int analyze_node(AstPool* pool, AstRef ref, SemanticScope* scope, SemaStack* stack) {
+    size_t offset = ast_pool_offset(pool, ref);
+    switch (ast_pool_kind(pool, ref)) {
         case AST_FUNCTION:
-            // New scope for function
-            {
-                Scope* func_scope = scope_push(scope);
-                *found_return = 0;
-                analyze_node(node->function.body, func_scope, found_return);
-                if (!*found_return) {
-                    report_error(ERROR_SEMANTIC, node->token ? node->token->line : 0, node->token ? node->token->column : 0, "Missing return statement in function");
-                    semantic_error = 1;
-                }
-                scope_pop(func_scope);
-            }
-            break;
+            // semantic_begin_function opened the function's scope
+            return sema_push(stack, SEMA_END_FUNCTION, ref) &&
+                   sema_push(stack, SEMA_VISIT, ast_pool_field(pool, ref, 1));
         case AST_BLOCK:
-        case AST_COMPOUND:
-            {
-                Scope* block_scope = scope_push(scope);
-                for (size_t i = 0; i < node->block.count; ++i) {
-                    analyze_node(node->block.statements[i], block_scope, found_return);
-                }
-                scope_pop(block_scope);
-            }
-            break;
-        case AST_DECLARATION:
-            if (!scope_insert(scope, node->declaration.name, 0)) {
-                report_error(ERROR_REDEFINITION, node->token ? node->token->line : 0, node->token ? node->token->column : 0, "Redeclaration of variable '%s'", node->declaration.name);
-                semantic_error = 1;
+        case AST_COMPOUND: {
+            if (!sema_push(stack, SEMA_POP_SCOPE, ref)) return 0;
+            semantic_open_block(scope);
+            for (size_t i = ast_pool_field(pool, ref, 0); i-- > 0;) {
+                if (!sema_push(stack, SEMA_VISIT, ast_pool_statement(pool, ref, i))) return 0;
             }
-            if (node->declaration.init)
-                analyze_node(node->declaration.init, scope, found_return);
-            break;
-        case AST_ASSIGNMENT:
-            if (!scope_lookup(scope, node->assignment.name)) {
-                report_error(ERROR_UNDEFINED_VAR, node->token ? node->token->line : 0, node->token ? node->token->column : 0, "Assignment to undeclared variable '%s'", node->assignment.name);
-                semantic_error = 1;
-            }
-            analyze_node(node->assignment.value, scope, found_return);
-            break;
-        case AST_IDENTIFIER:
-            if (!scope_lookup(scope, node->identifier)) {
-                report_error(ERROR_UNDEFINED_VAR, node->token ? node->token->line : 0, node->token ? node->token->column : 0, "Use of undeclared variable '%s'", node->identifier);
-                semantic_error = 1;
-            }
-            break;
+            return 1;
+        }
+        case AST_DECLARATION: {
+            // Only int is supported for now, so a binding just records its declaration
+            uint32_t slot = semantic_declare(scope, ast_pool_field(pool, ref, 0), ref, offset);
+            ast_pool_set_field(pool, ref, 2, slot);
+            return sema_push(stack, SEMA_VISIT, ast_pool_field(pool, ref, 1));
+        }
+        case AST_ASSIGNMENT: {
+            uint32_t decl = AST_REF_NONE;
+            semantic_use(scope, ast_pool_field(pool, ref, 0), 1, offset, &decl);
+            ast_pool_set_field(pool, ref, 2, decl);
+            return sema_push(stack, SEMA_VISIT, ast_pool_field(pool, ref, 1));
+        }
+        case AST_IDENTIFIER: {
+            uint32_t decl = AST_REF_NONE;
+            semantic_use(scope, ast_pool_field(pool, ref, 0), 0, offset, &decl);
+            ast_pool_set_field(pool, ref, 1, decl);
+            return 1;
+        }
         case AST_BINARY_OP:
-            analyze_node(node->binop.left, scope, found_return);
-            analyze_node(node->binop.right, scope, found_return);
-            break;
-        case AST_IF:
-            analyze_node(node->if_stmt.condition, scope, found_return);
-            analyze_node(node->if_stmt.then_branch, scope, found_return);
-            if (node->if_stmt.else_branch)
-                analyze_node(node->if_stmt.else_branch, scope, found_return);
-            break;
         case AST_WHILE:
-            analyze_node(node->while_stmt.condition, scope, found_return);
-            analyze_node(node->while_stmt.body, scope, found_return);
-            break;
+            return sema_push(stack, SEMA_VISIT, ast_pool_field(pool, ref, 1)) &&
+                   sema_push(stack, SEMA_VISIT, ast_pool_field(pool, ref, 0));
+        case AST_IF:
+            return sema_push(stack, SEMA_VISIT, ast_pool_field(pool, ref, 2)) &&
+                   sema_push(stack, SEMA_VISIT, ast_pool_field(pool, ref, 1)) &&
+                   sema_push(stack, SEMA_VISIT, ast_pool_field(pool, ref, 0));
         case AST_RETURN:
-            *found_return = 1;
-            analyze_node(node->return_stmt.expr, scope, found_return);
-            break;
+            scope->found_return = 1;
+            return sema_push(stack, SEMA_VISIT, ast_pool_field(pool, ref, 0));
         default:
-            break;
+            return 1;
+    }
+}
+
+void analyze_function_pool(AstPool* pool, AstRef function, SemanticResult* result) {
+    SemanticScope scope;
+    semantic_scope_init(&scope);
+    semantic_begin_function(&scope, result);
+
+    // Walked with an explicit stack, so nesting depth costs heap, not native stack
+    SemaStack stack = { NULL, 0, 0 };
+    if (!sema_push(&stack, SEMA_VISIT, function)) scope.out_of_memory = 1;
+    while (stack.count > 0) {
+        SemaItem item = stack.items[--stack.count];
+        switch (item.action) {
+            case SEMA_VISIT:
+                if (!scope.out_of_memory && !analyze_node(pool, item.ref, &scope, &stack)) scope.out_of_memory = 1;
+                break;
+            case SEMA_END_FUNCTION:
+                ast_pool_set_field(pool, item.ref, 2, semantic_end_function(&scope, ast_pool_offset(pool, item.ref)));
+                break;
+            case SEMA_POP_SCOPE:
+                semantic_close_block(&scope);
+                break;
+        }
+    }
+    // Anything but a function is only checked for names
+    if (scope.out_of_memory && ast_pool_kind(pool, function) != AST_FUNCTION) {
+        sema_error(result, ERROR_SEMANTIC, ast_pool_offset(pool, function), "Out of memory during semantic analysis");
     }
+    free(stack.items);
+    semantic_scope_free(&scope);
+}
+
+typedef struct SemanticJob {
+    AstPool* pool;
+    AstRef program;
+    SemanticResult* results;
+} SemanticJob;
+
+static void analyze_function_task(void* context, size_t index) {
+    SemanticJob* job = context;
+    analyze_function_pool(job->pool, ast_pool_statement(job->pool, job->program, index), &job->results[index]);
+}
+
+int first_semantic_error(const AstPool* pool, const SemanticResult* results, size_t count, SemanticResult* out) {
+    AstRef program = pool->root;
+    // A function name may only be defined once; atoms index the seen flags
+    unsigned char* defined = calloc((size_t)atom_count() + 1, 1);
+    int found = 0;
+    for (size_t i = 0; i < count && !found; ++i) {
+        AstRef function = ast_pool_statement(pool, program, i);
+        Atom name = ast_pool_field(pool, function, 0);
+        found = 1;
+        if (defined && defined[name]) {
+            out->errors = 1;
+            out->first_type = ERROR_REDEFINITION;
+            out->first_offset = ast_pool_offset(pool, function);
+            snprintf(out->first_message, sizeof(out->first_message), "Redefinition of function '%s'",
+                     atom_name(name));
+        } else if (results[i].errors) {
+            *out = results[i];
+        } else {
+            found = 0;
+            if (defined) defined[name] = 1;
+        }
+    }
+    free(defined);
+    return found;
+}
+
+void report_semantic_results(const AstPool* pool, const SemanticResult* results, size_t count) {
+    SemanticResult first;
+    if (first_semantic_error(pool, results, count, &first)) {
+        semantic_error = 1;
+        report_error_at(first.first_type, first.first_offset, "%s", first.first_message);
+    }
+}
+
+void analyze_semantics_pool(AstPool* pool, int threads) {
+    TRACE(TRACE_SEMA, "begin", "nodes=%zu words=%zu", pool->nodes, pool->count);
+    AstRef root = pool->root;
+    if (root && ast_pool_kind(pool, root) == AST_PROGRAM) {
+        size_t count = ast_pool_field(pool, root, 0);
+        SemanticResult* results = malloc((count ? count : 1) * sizeof(SemanticResult));
+        if (!results) {
+            fprintf(stderr, "[ERROR] Out of memory during semantic analysis\n");
+            semantic_error = 1;
+            return;
+        }
+        SemanticJob job = { pool, root, results };
+        parallel_for(count, threads, analyze_function_task, &job);
+        report_semantic_results(pool, results, count);
+        free(results);
+    } else if (root) {
+        SemanticResult result;
+        analyze_function_pool(pool, root, &result);
+        if (result.errors) {
+            semantic_error = 1;
+            report_error_at(result.first_type, result.first_offset, "%s", result.first_message);
+        }
+    }
+    TRACE(TRACE_SEMA, "end", "errors=%d", semantic_error);
 }
 
 void analyze_semantics(ASTNode* root) {
-    fprintf(stderr, "[DEBUG] Entering analyze_semantics (new)\n");
-    Scope* global = scope_push(NULL);
-    int found_return = 0;
-    analyze_node(root, global, &found_return);
-    scope_pop(global);
-    fprintf(stderr, "[DEBUG] Exiting analyze_semantics (new)\n");
+    AstPool* pool = ast_pool_build(root);
+    if (!pool) {
+        fprintf(stderr, "[ERROR] Out of memory building the AST pool\n");
+        semantic_error = 1;
+        return;
+    }
+    analyze_semantics_pool(pool, 0);
+    free_ast_pool(pool);
 }
 
 int get_semantic_error() {
@@ -1,11 +1,66 @@
 #ifndef SEMANTIC_ANALYZER_H
 #define SEMANTIC_ANALYZER_H
 
-#include "..\utils\symbol_table.h"
-#include "..\parser\ast.h"
+#include "../utils/symbol_table.h"
+#include "../utils/scoped_table.h"
+#include "../parser/ast.h"
+#include "../parser/ast_pool.h"
+#include "../utils/error_handler.h"
 
 
-void analyze_semantics(ASTNode* root);
+void analyze_semantics(ASTNode* root);  // copies the tree into an AstPool first
+// Checks every function of an AST_PROGRAM on up to `threads` threads (<= 0:
+// one per CPU), binds their names (see ast_pool.h) and reports the first
+// error in source order.
+void analyze_semantics_pool(AstPool* pool, int threads);
+
+// Outcome of checking one function. analyze_function_pool reads the atom
+// table and writes only the binding words of the function's own nodes, so
+// several functions of one pool may be checked at once.
+typedef struct SemanticResult {
+    int errors;
+    ErrorType first_type;
+    size_t first_offset;
+    char first_message[256];
+} SemanticResult;
+
+void analyze_function_pool(AstPool* pool, AstRef function, SemanticResult* result);
+// Reports the first error of an AST_PROGRAM pool's functions in source
+// order, given one result per function (from the analyzer or a fused parse)
+void report_semantic_results(const AstPool* pool, const SemanticResult* results, size_t count);
+// The error report_semantic_results reports, copied to `out` instead;
+// returns 0 if there is none
+int first_semantic_error(const AstPool* pool, const SemanticResult* results, size_t count, SemanticResult* out);
+
+// Scope and name checks of one function, fed declarations, uses and block
+// boundaries in source order: by analyze_function_pool as it walks a pool,
+// or by the parser as it reads the source (fused mode). Both report through
+// these calls, so they give the same diagnostics. After running out of
+// memory every call is a no-op and the function reports it when it ends.
+typedef struct SemanticScope {
+    ScopedTable table;
+    SemanticResult* result;
+    int found_return;
+    int out_of_memory;
+} SemanticScope;
+
+void semantic_scope_init(SemanticScope* scope);
+void semantic_scope_free(SemanticScope* scope);
+// Starts checking a function into `result`, dropping whatever an abandoned
+// one left open, and opens the function's scope
+void semantic_begin_function(SemanticScope* scope, SemanticResult* result);
+// Reports a missing return statement and closes the function's scopes;
+// returns the number of frame slots the function needs
+uint32_t semantic_end_function(SemanticScope* scope, size_t offset);
+void semantic_open_block(SemanticScope* scope);
+void semantic_close_block(SemanticScope* scope);
+// Declares `name` in the innermost scope, keeping `value` with it. Returns
+// its frame slot, or AST_SLOT_NONE for a redeclaration.
+uint32_t semantic_declare(SemanticScope* scope, Atom name, uint32_t value, size_t offset);
+// Resolves a use of `name`, or with `assignment` the target of an
+// assignment. Returns the frame slot and sets *value (if not NULL), or
+// returns AST_SLOT_NONE for an undeclared name.
+uint32_t semantic_use(SemanticScope* scope, Atom name, int assignment, size_t offset, uint32_t* value);
 int get_semantic_error();
 
 
@@ -32,6 +32,24 @@ bool assert_str_equals(const char* expected, const char* actual, const char* tes
     }
 }
 
+bool check_int_equals(TestStats* stats, int expected, int actual, const char* test_name) {
+    stats->tests_run++;
+    if (assert_int_equals(expected, actual, test_name)) {
+        stats->tests_passed++;
+        return true;
+    }
+    stats->tests_failed++;
+    return false;
+}
+
+size_t count_substrings(const char* text, size_t length, const char* needle) {
+    size_t count = 0, n = strlen(needle);
+    for (size_t i = 0; i + n <= length; ++i) {
+        if (text[i] == needle[0] && memcmp(text + i, needle, n) == 0) count++;
+    }
+    return count;
+}
+
 void print_test_results(TestStats* stats) {
     printf("\nTest Summary:\n");
     printf("Total tests: %d\n", stats->tests_run);
@@ -2,6 +2,7 @@
 #define TEST_FRAMEWORK_H
 
 #include <stdbool.h>
+#include <stddef.h>
 
 typedef struct {
     int tests_run;
@@ -14,6 +15,10 @@ void init_test_stats(TestStats* stats);
 void run_test_suite(TestStats* stats);
 bool assert_int_equals(int expected, int actual, const char* test_name);
 bool assert_str_equals(const char* expected, const char* actual, const char* test_name);
+// assert_int_equals that also counts the test in `stats`
+bool check_int_equals(TestStats* stats, int expected, int actual, const char* test_name);
+// Occurrences of `needle` in the first `length` bytes of `text`
+size_t count_substrings(const char* text, size_t length, const char* needle);
 void print_test_results(TestStats* stats);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,227 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../incremental/incremental.h"
+#include "../parser/parser.h"
+#include "../parser/ast_pool.h"
+#include "../codegen/asm_generator.h"
+#include "test_framework.h"
+
+// Whole contents of `file`, which is closed
+static char* read_back(FILE* file) {
+    long length = ftell(file);
+    char* text = malloc((size_t)length + 1);
+    rewind(file);
+    if (text) text[fread(text, 1, (size_t)length, file)] = '\0';
+    fclose(file);
+    return text;
+}
+
+static char* assembly_of(const IncrementalSession* session) {
+    FILE* file = tmpfile();
+    if (!file) return NULL;
+    incremental_write_assembly(session, file);
+    return read_back(file);
+}
+
+// Compiles `source` the way a normal build does: token buffer, one parse of
+// the whole file, the AST pool, semantic analysis and code generation.
+// Returns 1 and fills `error` if the program has an error (a syntax error
+// only sets the type), otherwise 0 with the assembly in *assembly.
+static int compile_full(const char* source, IncrementalDiagnostic* error, char** assembly) {
+    *assembly = NULL;
+    Lexer lexer;
+    lexer_init_span(&lexer, source, strlen(source));
+    TokenBuffer* tokens = lexer_tokenize(&lexer);
+    Parser* parser = tokens ? create_parser_from_tokens(tokens) : NULL;
+    Arena* arena = create_arena(0);
+    ASTNode* root = NULL;
+    if (parser && arena) {
+        parser->quiet = 1;
+        parser->arena = arena;
+        root = parse_program(parser);
+    }
+    AstPool* pool = root ? ast_pool_build(root) : NULL;
+    free_arena(arena);
+    free_parser(parser);
+    free_token_buffer(tokens);
+
+    int failed = 1;
+    error->type = ERROR_SYNTAX;
+    size_t count = pool ? ast_pool_field(pool, pool->root, 0) : 0;
+    SemanticResult* results = pool ? calloc(count ? count : 1, sizeof(SemanticResult)) : NULL;
+    if (results) {
+        for (size_t i = 0; i < count; ++i) {
+            analyze_function_pool(pool, ast_pool_statement(pool, pool->root, i), &results[i]);
+        }
+        SemanticResult first;
+        failed = first_semantic_error(pool, results, count, &first);
+        if (failed) {
+            error->type = first.first_type;
+            error->offset = first.first_offset;
+            snprintf(error->message, sizeof(error->message), "%s", first.first_message);
+        } else {
+            FILE* file = tmpfile();
+            if (file) {
+                generate_program_header(file);
+                generate_program_pool(file, pool, 1, CODEGEN_IR);
+                *assembly = read_back(file);
+            }
+        }
+    }
+    free(results);
+    free_ast_pool(pool);
+    return failed;
+}
+
+static int same_error(const IncrementalDiagnostic* expected, const IncrementalDiagnostic* actual) {
+    if (expected->type != actual->type) return 0;
+    return expected->type == ERROR_SYNTAX ||
+           (expected->offset == actual->offset && strcmp(expected->message, actual->message) == 0);
+}
+
+// The session reports the same first error as a full build of `source`, or
+// compiles to the same assembly when there is none; so does a fresh session
+// opened on `source`
+static int matches_full_build(const IncrementalSession* session, const char* source) {
+    IncrementalDiagnostic expected_error, actual_error;
+    char* expected = NULL;
+    int failed = compile_full(source, &expected_error, &expected);
+    char* actual = assembly_of(session);
+    int same = failed == incremental_check(session, &actual_error);
+    if (same && failed) {
+        same = same_error(&expected_error, &actual_error);
+    } else if (same) {
+        same = expected && actual && strcmp(expected, actual) == 0;
+    }
+    free(expected);
+
+    IncrementalSession* fresh = incremental_open(source, strlen(source));
+    failed = fresh ? incremental_check(fresh, &expected_error) : 0;
+    same = same && fresh && failed == incremental_check(session, &actual_error);
+    if (same && failed) {
+        same = expected_error.type == actual_error.type && expected_error.offset == actual_error.offset &&
+               strcmp(expected_error.message, actual_error.message) == 0;
+    } else if (same) {
+        expected = assembly_of(fresh);
+        same = expected && actual && strcmp(expected, actual) == 0;
+        free(expected);
+    }
+    free(actual);
+    free_incremental_session(fresh);
+    return same;
+}
+
+void test_incremental(TestStats* stats) {
+    printf("\nRunning Incremental Compilation Tests...\n");
+
+    const char* source =
+        "int first() {\n    int a = 1;\n    return a;\n}\n\n"
+        "int second() {\n    int b = 2;\n    return b;\n}\n\n"
+        "int main() {\n    int c = 3;\n    return c;\n}\n";
+    IncrementalSession* session = incremental_open(source, strlen(source));
+    IncrementalDiagnostic diagnostic;
+    check_int_equals(stats, 1, session != NULL, "open");
+    if (!session) return;
+    check_int_equals(stats, 3, (int)session->count, "open: unit count");
+    check_int_equals(stats, 0, incremental_check(session, &diagnostic), "open: no error");
+
+    // Editing a body recompiles that definition only and keeps the other trees
+    const ASTNode* first = session->units[0]->function;
+    const ASTNode* last = session->units[2]->function;
+    const char* edited =
+        "int first() {\n    int a = 1;\n    return a;\n}\n\n"
+        "int second() {\n    int b = 2 * 21;\n    return b;\n}\n\n"
+        "int main() {\n    int c = 3;\n    return c;\n}\n";
+    check_int_equals(stats, 1, incremental_update(session, edited, strlen(edited)), "edit: update");
+    check_int_equals(stats, 1, (int)session->reparsed_units, "edit: reparsed units");
+    check_int_equals(stats, 1, session->units[0]->function == first, "edit: first tree kept");
+    check_int_equals(stats, 1, session->units[2]->function == last, "edit: last tree kept");
+    check_int_equals(stats, 1, matches_full_build(session, edited), "edit: matches full build");
+
+    // Adding and removing whole definitions
+    const char* added =
+        "int first() {\n    int a = 1;\n    return a;\n}\n\n"
+        "int second() {\n    int b = 2 * 21;\n    return b;\n}\n\n"
+        "int third() { int d = 4; while (d > 0) { d = d - 1; } return d; }\n"
+        "int main() {\n    int c = 3;\n    return c;\n}\n";
+    check_int_equals(stats, 1, incremental_update(session, added, strlen(added)), "insert: update");
+    check_int_equals(stats, 4, (int)session->count, "insert: unit count");
+    check_int_equals(stats, 1, session->units[0]->function == first, "insert: first tree kept");
+    check_int_equals(stats, 1, matches_full_build(session, added), "insert: matches full build");
+    check_int_equals(stats, 1, incremental_update(session, source, strlen(source)), "remove: update");
+    check_int_equals(stats, 3, (int)session->count, "remove: unit count");
+    check_int_equals(stats, 1, matches_full_build(session, source), "remove: matches full build");
+
+    // Diagnostics point into the whole source
+    const char* missing_return =
+        "int first() {\n    int a = 1;\n    return a;\n}\n\n"
+        "int second() {\n    int b = 2;\n}\n\n"
+        "int main() {\n    int c = 3;\n    return c;\n}\n";
+    size_t line = 0, column = 0;
+    check_int_equals(stats, 1, incremental_update(session, missing_return, strlen(missing_return)),
+                     "missing return: update");
+    int reported = incremental_check(session, &diagnostic);
+    if (reported) incremental_position(session, diagnostic.offset, &line, &column);
+    check_int_equals(stats, 1, reported, "missing return: reported");
+    check_int_equals(stats, ERROR_SEMANTIC, reported ? (int)diagnostic.type : -1, "missing return: error type");
+    check_int_equals(stats, 6, (int)line, "missing return: line");
+    check_int_equals(stats, 1, (int)column, "missing return: column");
+    check_int_equals(stats, 1, matches_full_build(session, missing_return), "missing return: matches full build");
+
+    const char* redefined =
+        "int first() {\n    int a = 1;\n    return a;\n}\n\n"
+        "int first() {\n    int b = 2;\n    return b;\n}\n\n"
+        "int main() {\n    int c = 3;\n    return c;\n}\n";
+    check_int_equals(stats, 1, incremental_update(session, redefined, strlen(redefined)), "redefinition: update");
+    reported = incremental_check(session, &diagnostic);
+    check_int_equals(stats, 1, reported, "redefinition: reported");
+    check_int_equals(stats, ERROR_REDEFINITION, reported ? (int)diagnostic.type : -1, "redefinition: error type");
+    check_int_equals(stats, 1, matches_full_build(session, redefined), "redefinition: matches full build");
+
+    // An unbalanced brace only breaks the definition it is in, until it is fixed
+    const char* broken =
+        "int first() {\n    int a = 1;\n    return a;\n}\n\n"
+        "int second() {\n    int b = 2;\n    return b;\n\n\n"
+        "int main() {\n    int c = 3;\n    return c;\n}\n";
+    check_int_equals(stats, 1, incremental_update(session, broken, strlen(broken)), "syntax error: update");
+    reported = incremental_check(session, &diagnostic);
+    check_int_equals(stats, 1, reported, "syntax error: reported");
+    check_int_equals(stats, ERROR_SYNTAX, reported ? (int)diagnostic.type : -1, "syntax error: error type");
+    check_int_equals(stats, 1, matches_full_build(session, broken), "syntax error: matches full build");
+    check_int_equals(stats, 1, incremental_update(session, source, strlen(source)), "syntax error fixed: update");
+    check_int_equals(stats, 0, incremental_check(session, &diagnostic), "syntax error fixed: no error");
+    check_int_equals(stats, 1, matches_full_build(session, source), "syntax error fixed: matches full build");
+
+    // A name declared in an earlier definition parses, as in a full build, and
+    // the semantic check rejects it; once no definition declares it, the use
+    // no longer parses, even though only the earlier definition was edited
+    const char* borrowed =
+        "int first() {\n    int a = 1;\n    return a;\n}\n\n"
+        "int main() {\n    int c = a + 2;\n    return c;\n}\n";
+    check_int_equals(stats, 1, incremental_update(session, borrowed, strlen(borrowed)), "borrowed name: update");
+    reported = incremental_check(session, &diagnostic);
+    line = column = 0;
+    if (reported) incremental_position(session, diagnostic.offset, &line, &column);
+    check_int_equals(stats, 1, reported, "borrowed name: reported");
+    check_int_equals(stats, ERROR_UNDEFINED_VAR, reported ? (int)diagnostic.type : -1, "borrowed name: error type");
+    check_int_equals(stats, 7, (int)line, "borrowed name: line");
+    check_int_equals(stats, 13, (int)column, "borrowed name: column");
+    check_int_equals(stats, 1, matches_full_build(session, borrowed), "borrowed name: matches full build");
+    const char* undeclared =
+        "int first() {\n    int x = 1;\n    return x;\n}\n\n"
+        "int main() {\n    int c = a + 2;\n    return c;\n}\n";
+    check_int_equals(stats, 1, incremental_update(session, undeclared, strlen(undeclared)),
+                     "name no longer declared: update");
+    reported = incremental_check(session, &diagnostic);
+    check_int_equals(stats, 1, reported, "name no longer declared: reported");
+    check_int_equals(stats, ERROR_SYNTAX, reported ? (int)diagnostic.type : -1,
+                     "name no longer declared: error type");
+    check_int_equals(stats, 1, matches_full_build(session, undeclared),
+                     "name no longer declared: matches full build");
+    check_int_equals(stats, 1, incremental_update(session, borrowed, strlen(borrowed)),
+                     "name declared again: update");
+    check_int_equals(stats, 1, matches_full_build(session, borrowed), "name declared again: matches full build");
+
+    free_incremental_session(session);
+}
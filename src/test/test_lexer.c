@@ -1,5 +1,8 @@
 #include <stdio.h>  // ✅ Needed for printf
+#include <string.h>
 #include "../lexer/lexer.h"
+#include "../lexer/token_buffer.h"
+#include "test_framework.h"
 
 void test_lexer() {
     printf("\nRunning Lexer Tests...\n");
@@ -9,9 +12,208 @@ void test_lexer() {
 
     Token* token;
     while ((token = get_next_token(lexer)) && token->type != TOKEN_EOF) {
-        printf("Token: %d, Value: %s\n", token->type, token->value);
+        printf("Token: %d, Value: %.*s\n", token->type, (int)token->length, token->text);
         free_token(token);
     }
 
     free_lexer(lexer);
 }
+
+// Feeds a string to a streaming lexer at most `step` bytes per refill
+typedef struct {
+    const char* text;
+    size_t length;
+    size_t position;
+    size_t step;
+} StringSource;
+
+static size_t refill_from_string(void* ctx, char* buffer, size_t capacity) {
+    StringSource* src = ctx;
+    size_t n = src->length - src->position;
+    if (n > capacity) n = capacity;
+    if (n > src->step) n = src->step;
+    memcpy(buffer, src->text + src->position, n);
+    src->position += n;
+    return n;
+}
+
+// Tokens cut by chunk boundaries must come out exactly as from a whole buffer
+void test_lexer_streaming(TestStats* stats) {
+    printf("\nRunning Streaming Lexer Tests...\n");
+
+    const char* input =
+        "int main() {\n"
+        "    int a_rather_long_identifier_name = 1234567;\n"
+        "    if (a_rather_long_identifier_name >= 10 != 0) { return 7 <= 8; }\n"
+        "    while (x == y) x = x - 1;\n"
+        "    return a_rather_long_identifier_name;\n"
+        "}\n";
+    size_t chunk_sizes[] = { 1, 2, 3, 5, 16, 4096 };
+
+    for (size_t c = 0; c < sizeof(chunk_sizes) / sizeof(chunk_sizes[0]); ++c) {
+        Lexer* whole = create_lexer(input);
+        StringSource src = { input, strlen(input), 0, chunk_sizes[c] };
+        Lexer* stream = create_lexer_streaming(refill_from_string, &src, chunk_sizes[c]);
+
+        int mismatches = 0;
+        Token expected, actual;
+        do {
+            lexer_scan_token(whole, &expected);
+            lexer_scan_token(stream, &actual);
+            if (expected.type != actual.type || expected.offset != actual.offset ||
+                expected.length != actual.length || expected.number != actual.number ||
+                memcmp(expected.text, actual.text, expected.length) != 0) {
+                mismatches++;
+            }
+        } while (expected.type != TOKEN_EOF && actual.type != TOKEN_EOF);
+
+        char name[64];
+        snprintf(name, sizeof(name), "streaming lexer, chunk size %zu", chunk_sizes[c]);
+        check_int_equals(stats, 0, mismatches, name);
+
+        free_lexer(whole);
+        free_lexer(stream);
+    }
+}
+
+// Equal spellings share one atom wherever they appear; the name round-trips
+void test_lexer_interning(TestStats* stats) {
+    printf("\nRunning Identifier Interning Tests...\n");
+
+    Lexer* lexer = create_lexer("count = count + counter;");
+    Token first, second, third;
+    lexer_scan_token(lexer, &first);   // count
+    lexer_scan_token(lexer, &second);  // =
+    lexer_scan_token(lexer, &second);  // count
+    lexer_scan_token(lexer, &third);   // +
+    lexer_scan_token(lexer, &third);   // counter
+
+    int ok = first.atom != ATOM_NONE && first.atom == second.atom &&
+             first.atom != third.atom && first.atom == intern_cstr("count") &&
+             strcmp(atom_name(third.atom), "counter") == 0;
+    check_int_equals(stats, 1, ok, "identifier atoms");
+
+    // Names whose hashes collide stay distinct, whichever is interned first
+    Atom shorter = intern_hashed("abc", 3, 42);
+    Atom longer = intern_hashed("abcdefgh", 8, 42);
+    ok = shorter != ATOM_NONE && longer != ATOM_NONE && shorter != longer &&
+         intern_hashed("abc", 3, 42) == shorter && intern_hashed("abcdefgh", 8, 42) == longer;
+    check_int_equals(stats, 1, ok, "colliding hashes");
+
+    free_lexer(lexer);
+}
+
+// The batch token buffer must hold exactly the tokens the scanner produces
+void test_token_buffer(TestStats* stats) {
+    printf("\nRunning Token Buffer Tests...\n");
+
+    const char* input =
+        "int main() {\n"
+        "    int total = 2147483647;\n"
+        "    while (total >= 10) total = total - 10;\n"
+        "    return total;\n"
+        "}\n";
+    Lexer* scanner = create_lexer(input);
+    Lexer* batch = create_lexer(input);
+    TokenBuffer* tokens = lexer_tokenize(batch);
+
+    int mismatches = tokens ? 0 : 1;
+    Token expected, actual;
+    for (size_t i = 0; tokens; ++i) {
+        lexer_scan_token(scanner, &expected);
+        token_buffer_get(tokens, i, &actual);
+        if (expected.type != actual.type || expected.offset != actual.offset ||
+            expected.length != actual.length || expected.number != actual.number ||
+            memcmp(expected.text, actual.text, expected.length) != 0) {
+            mismatches++;
+        }
+        if (expected.type == TOKEN_EOF) {
+            if (i + 1 != tokens->count) mismatches++;
+            break;
+        }
+    }
+    check_int_equals(stats, 0, mismatches, "token buffer matches scanner");
+
+    free_token_buffer(tokens);
+    free_lexer(scanner);
+    free_lexer(batch);
+}
+
+// Positions resolved from offsets must match a byte-by-byte line/column count
+void test_lexer_positions(TestStats* stats) {
+    printf("\nRunning Lexer Position Tests...\n");
+
+    const char* input = "int a;\n\n  a = 1;\r\n\tif (a) {\n  return a;\n}\n";
+    StringSource src = { input, strlen(input), 0, 3 };
+    Lexer* lexers[2] = { create_lexer(input), create_lexer_streaming(refill_from_string, &src, 3) };
+
+    for (int k = 0; k < 2; ++k) {
+        int mismatches = 0;
+        Token token;
+        do {
+            lexer_scan_token(lexers[k], &token);
+            size_t line = 1, column = 1;
+            for (size_t i = 0; i < token.offset; ++i) {
+                if (input[i] == '\n') {
+                    line++;
+                    column = 1;
+                } else {
+                    column++;
+                }
+            }
+            size_t resolved_line, resolved_column;
+            line_index_resolve(&lexers[k]->lines, token.offset, &resolved_line, &resolved_column);
+            if (resolved_line != line || resolved_column != column) mismatches++;
+        } while (token.type != TOKEN_EOF);
+
+        check_int_equals(stats, 0, mismatches, k == 0 ? "positions, whole buffer" : "positions, streaming");
+        free_lexer(lexers[k]);
+    }
+}
+
+static int same_token_buffers(const TokenBuffer* a, const TokenBuffer* b) {
+    if (!a || !b || a->count != b->count) return 0;
+    return memcmp(a->types, b->types, a->count * sizeof(a->types[0])) == 0 &&
+           memcmp(a->offsets, b->offsets, a->count * sizeof(a->offsets[0])) == 0 &&
+           memcmp(a->lengths, b->lengths, a->count * sizeof(a->lengths[0])) == 0 &&
+           memcmp(a->payloads, b->payloads, a->count * sizeof(a->payloads[0])) == 0;
+}
+
+// Lexing in parallel chunks must give exactly the sequential token stream,
+// including around stray bytes and a NUL that ends the input early
+void test_token_buffer_parallel(TestStats* stats) {
+    printf("\nRunning Parallel Tokenization Tests...\n");
+
+    char source[4096];
+    size_t length = 0;
+    const char* lines[] = {
+        "int value_%zu = %zu;\n", "while (x >= 10) x = x - 1;\n",
+        "\x01\n", "a\x02 \n", "\x7f\n\n", "if (a != b) { return 0; }\n",
+    };
+    for (size_t i = 0; length + 64 < sizeof(source) / 2; ++i) {
+        length += (size_t)snprintf(source + length, sizeof(source) - length, lines[i % 6], i, i * 7);
+    }
+    size_t nul_at = length;
+    source[length++] = '\0';
+    while (length + 64 < sizeof(source)) {
+        length += (size_t)snprintf(source + length, sizeof(source) - length, "after_nul = %zu;\n", length);
+    }
+
+    for (int pass = 0; pass < 2; ++pass) {
+        size_t n = pass == 0 ? nul_at : length;  // without and with the NUL byte
+        Lexer sequential, parallel;
+        lexer_init_span(&sequential, source, n);
+        TokenBuffer* expected = lexer_tokenize(&sequential);
+
+        int mismatches = 0;
+        for (int threads = 1; threads <= 8; ++threads) {
+            lexer_init_span(&parallel, source, n);
+            TokenBuffer* actual = lexer_tokenize_parallel(&parallel, threads, 32);
+            if (!same_token_buffers(expected, actual)) mismatches++;
+            free_token_buffer(actual);
+        }
+
+        check_int_equals(stats, 0, mismatches, pass == 0 ? "parallel tokenization" : "parallel tokenization, NUL byte");
+        free_token_buffer(expected);
+    }
+}
@@ -3,7 +3,25 @@
 
 // Forward declarations of test suites
 void test_lexer(TestStats* stats);
+void test_lexer_streaming(TestStats* stats);
+void test_lexer_interning(TestStats* stats);
+void test_token_buffer(TestStats* stats);
+void test_lexer_positions(TestStats* stats);
+void test_token_buffer_parallel(TestStats* stats);
 void test_parser(TestStats* stats);
+void test_parser_token_buffer(TestStats* stats);
+void test_parser_arena(TestStats* stats);
+void test_parser_precedence(TestStats* stats);
+void test_ast_pool(TestStats* stats);
+void test_parser_functions(TestStats* stats);
+void test_parser_lalr(TestStats* stats);
+void test_parser_parallel(TestStats* stats);
+void test_parser_fused(TestStats* stats);
+void test_deep_nesting(TestStats* stats);
+void test_frame_slots(TestStats* stats);
+void test_ir_operands(TestStats* stats);
+void test_incremental(TestStats* stats);
+void test_scoped_table(TestStats* stats);
 void test_semantic(TestStats* stats);
 void test_optimizer(TestStats* stats);
 void test_codegen(TestStats* stats);
@@ -14,7 +32,25 @@ int main() {
 
     // Run all test suites
     test_lexer(&stats);
+    test_lexer_streaming(&stats);
+    test_lexer_interning(&stats);
+    test_token_buffer(&stats);
+    test_lexer_positions(&stats);
+    test_token_buffer_parallel(&stats);
     test_parser(&stats);
+    test_parser_token_buffer(&stats);
+    test_parser_arena(&stats);
+    test_parser_precedence(&stats);
+    test_ast_pool(&stats);
+    test_parser_functions(&stats);
+    test_parser_lalr(&stats);
+    test_parser_parallel(&stats);
+    test_parser_fused(&stats);
+    test_deep_nesting(&stats);
+    test_frame_slots(&stats);
+    test_ir_operands(&stats);
+    test_incremental(&stats);
+    test_scoped_table(&stats);
     test_semantic(&stats);
     test_optimizer(&stats);
     test_codegen(&stats);
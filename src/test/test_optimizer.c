@@ -0,0 +1,109 @@
+#include <stdio.h>
+#include "../lexer/lexer.h"
+#include "../parser/parser.h"
+#include "../parser/ast_pool.h"
+#include "../semantic/semantic_analyzer.h"
+#include "../ir/ir_generator.h"
+#include "../ir/optimizer.h"
+#include "../codegen/asm_generator.h"
+#include "test_framework.h"
+
+// Parses and checks a one-function program; NULL if it does not compile
+static AstPool* compile_function(const char* source) {
+    Lexer* lexer = create_lexer(source);
+    Parser* parser = create_parser(lexer);
+    Arena* arena = create_arena(0);
+    parser->arena = arena;
+    ASTNode* root = parse_program(parser);
+    AstPool* pool = root ? ast_pool_build(root) : NULL;
+    SemanticResult result = {0};
+    if (pool) analyze_function_pool(pool, ast_pool_statement(pool, pool->root, 0), &result);
+    if (pool && result.errors) {
+        free_ast_pool(pool);
+        pool = NULL;
+    }
+    free_arena(arena);
+    free_parser(parser);
+    free_lexer(lexer);
+    return pool;
+}
+
+// Checks one field of instruction `index`, naming it in the report
+static void check_field(TestStats* stats, const char* program, size_t index, const char* field, int expected,
+                        int actual) {
+    char name[96];
+    snprintf(name, sizeof(name), "%s IR [%zu] %s", program, index, field);
+    check_int_equals(stats, expected, actual, name);
+}
+
+void test_optimizer(TestStats* stats) {
+    printf("\nRunning IR Optimizer Tests...\n");
+
+    // v0 = 10; v1 = 0; L0: t7 = v0 > v1; ifnot t7 goto L1; t11 = v0 / 2; t12 = v1 + t11;
+    // v1 = t12; goto L0; L1: goto L2; v0 = 0; goto L3; L2: L3: return v0
+    AstPool* pool = compile_function(
+        "int main() { int a = 2 * 3 + 4; int b; while (a > b) { b = b + a / 2; } if (1 < 0) { a = 0; } return a; }");
+    IRProgram program = {0};
+    AstRef function = pool ? ast_pool_statement(pool, pool->root, 0) : AST_REF_NONE;
+    int generated = pool && generate_ir_program(pool, ast_pool_field(pool, function, 1), &program);
+    check_int_equals(stats, 1, generated, "IR generated");
+    if (generated) {
+        optimize_ir(&program);
+        const IRInstruction* code = program.code;
+        check_int_equals(stats, 16, (int)program.count, "optimized instruction count");
+        if (program.count == 16) {
+            check_field(stats, "optimized", 0, "type", IR_ASSIGN, code[0].type);
+            check_field(stats, "optimized", 0, "source kind", IR_OPERAND_IMM, code[0].kinds[1]);
+            check_field(stats, "optimized", 0, "folded value", 10, (int)code[0].operands[1]);
+            check_field(stats, "optimized", 3, "type", IR_GT, code[3].type);
+            check_field(stats, "optimized", 3, "left kind", IR_OPERAND_VAR, code[3].kinds[1]);
+            check_field(stats, "optimized", 3, "right kind", IR_OPERAND_VAR, code[3].kinds[2]);
+            check_field(stats, "optimized", 5, "type", IR_DIV, code[5].type);
+            check_field(stats, "optimized", 5, "right kind", IR_OPERAND_IMM, code[5].kinds[2]);
+            check_field(stats, "optimized", 5, "right value", 2, (int)code[5].operands[2]);
+            check_field(stats, "optimized", 6, "right kind", IR_OPERAND_TEMP, code[6].kinds[2]);
+            check_field(stats, "optimized", 6, "right temp", (int)code[5].operands[0], (int)code[6].operands[2]);
+            check_field(stats, "optimized", 10, "type", IR_JUMP, code[10].type);
+            check_field(stats, "optimized", 15, "type", IR_RETURN, code[15].type);
+            check_field(stats, "optimized", 15, "source kind", IR_OPERAND_VAR, code[15].kinds[1]);
+        }
+    }
+    free_ir_program(&program);
+
+    // Nothing folds through a division by zero or past the range of an int
+    IRInstruction division[] = {
+        { IR_LOAD_CONST, { IR_OPERAND_TEMP, IR_OPERAND_IMM, IR_OPERAND_NONE }, { 0, 7, 0 } },
+        { IR_LOAD_CONST, { IR_OPERAND_TEMP, IR_OPERAND_IMM, IR_OPERAND_NONE }, { 1, 0, 0 } },
+        { IR_DIV, { IR_OPERAND_TEMP, IR_OPERAND_TEMP, IR_OPERAND_TEMP }, { 2, 0, 1 } },
+        { IR_MUL, { IR_OPERAND_TEMP, IR_OPERAND_IMM, IR_OPERAND_IMM }, { 3, 65536, 65536 } },
+    };
+    IRProgram unfolded = { division, 4, 4, 4, 0 };
+    optimize_ir(&unfolded);
+    check_int_equals(stats, 2, (int)unfolded.count, "unfolded instruction count");
+    check_field(stats, "unfolded", 0, "type", IR_DIV, division[0].type);
+    check_field(stats, "unfolded", 0, "divisor kind", IR_OPERAND_IMM, division[0].kinds[2]);
+    check_field(stats, "unfolded", 1, "type", IR_MUL, division[1].type);
+
+    // Lowered through the IR: folded constants are stored directly, and an
+    // expression needing more temps than there are registers spills to the stack
+    AsmGenerator* gen = pool ? create_asm_generator(NULL) : NULL;
+    if (gen) generate_function_pool(gen, pool, function);
+    check_int_equals(stats, 1, gen ? (int)count_substrings(gen->buffer, gen->length, "mov qword [rbp-8], 10") : -1,
+                     "folded constant stored directly");
+    check_int_equals(stats, 0, gen ? (int)count_substrings(gen->buffer, gen->length, "imul") : -1,
+                     "no multiplication left after folding");
+    free_asm_generator(gen);
+    free_ast_pool(pool);
+
+    pool = compile_function("int main() { int a = 1; return (a + 1) * ((a + 2) * ((a + 3) * ((a + 4) * "
+                            "((a + 5) * ((a + 6) * (a + 7)))))); }");
+    gen = pool ? create_asm_generator(NULL) : NULL;
+    if (gen) generate_function_pool(gen, pool, ast_pool_statement(pool, pool->root, 0));
+    // Balanced pushes and pops besides the frame's own
+    int pushes = gen ? (int)count_substrings(gen->buffer, gen->length, "    push ") : -1;
+    int pops = gen ? (int)count_substrings(gen->buffer, gen->length, "    pop ") : -1;
+    check_int_equals(stats, 1, pushes > 1, "IR lowering spills temps");
+    check_int_equals(stats, pushes, pops, "every spilled temp is popped");
+    free_asm_generator(gen);
+    free_ast_pool(pool);
+}
@@ -1,5 +1,9 @@
 #include <stdio.h>  // ✅ Needed for printf
+#include <stdlib.h>
+#include <string.h>
 #include "../parser/parser.h"
+#include "../parser/ast_pool.h"
+#include "test_framework.h"
 
 void test_parser() {
     printf("\nRunning Parser Tests...\n");
@@ -17,3 +21,417 @@ void test_parser() {
     free_parser(parser);
     free_lexer(lexer);
 }
+
+// Structural AST comparison, including source positions
+static int ast_equal(const ASTNode* a, const ASTNode* b) {
+    if (!a || !b) return a == b;
+    if (a->type != b->type || a->loc.offset != b->loc.offset) return 0;
+    switch (a->type) {
+        case AST_NUMBER: return a->value == b->value;
+        case AST_IDENTIFIER: return a->identifier == b->identifier;
+        case AST_BINARY_OP:
+            return a->binop.op_type == b->binop.op_type &&
+                   ast_equal(a->binop.left, b->binop.left) && ast_equal(a->binop.right, b->binop.right);
+        case AST_DECLARATION:
+            return a->declaration.name == b->declaration.name && ast_equal(a->declaration.init, b->declaration.init);
+        case AST_ASSIGNMENT:
+            return a->assignment.name == b->assignment.name && ast_equal(a->assignment.value, b->assignment.value);
+        case AST_COMPOUND:
+        case AST_BLOCK:
+        case AST_PROGRAM:
+            if (a->block.count != b->block.count) return 0;
+            for (size_t i = 0; i < a->block.count; ++i) {
+                if (!ast_equal(a->block.statements[i], b->block.statements[i])) return 0;
+            }
+            return 1;
+        case AST_IF:
+            return ast_equal(a->if_stmt.condition, b->if_stmt.condition) &&
+                   ast_equal(a->if_stmt.then_branch, b->if_stmt.then_branch) &&
+                   ast_equal(a->if_stmt.else_branch, b->if_stmt.else_branch);
+        case AST_WHILE:
+            return ast_equal(a->while_stmt.condition, b->while_stmt.condition) &&
+                   ast_equal(a->while_stmt.body, b->while_stmt.body);
+        case AST_RETURN: return ast_equal(a->return_stmt.expr, b->return_stmt.expr);
+        case AST_FUNCTION:
+            return a->function.name == b->function.name && ast_equal(a->function.body, b->function.body);
+    }
+    return 0;
+}
+
+// Parsing from a batch token buffer must build the same tree as the lexer path
+void test_parser_token_buffer(TestStats* stats) {
+    printf("\nRunning Parser Token Buffer Tests...\n");
+
+    const char* input =
+        "int main() {\n"
+        "    int a = 1 + 2 * 3;\n"
+        "    if (a > 5) { a = a - 1; } else { a = 0; }\n"
+        "    while (a != 0) a = a - 1;\n"
+        "    return a;\n"
+        "}\n";
+    Lexer* lexer = create_lexer(input);
+    Parser* parser = create_parser(lexer);
+    ASTNode* expected = parse_program(parser);
+
+    Lexer* batch = create_lexer(input);
+    TokenBuffer* tokens = lexer_tokenize(batch);
+    Parser* buffered = create_parser_from_tokens(tokens);
+    ASTNode* actual = buffered ? parse_program(buffered) : NULL;
+
+    check_int_equals(stats, 1, expected != NULL && ast_equal(expected, actual), "parse from token buffer");
+
+    free_ast(expected);
+    free_ast(actual);
+    free_parser(parser);
+    free_parser(buffered);
+    free_lexer(lexer);
+    free_token_buffer(tokens);
+    free_lexer(batch);
+}
+
+// An arena-built tree must match the heap-built one and need no free_ast walk
+void test_parser_arena(TestStats* stats) {
+    printf("\nRunning Parser Arena Tests...\n");
+
+    const char* input =
+        "int main() {\n"
+        "    int a = 4;\n"
+        "    { int b = a * 2; { a = b - 1; } }\n"
+        "    while (a > 0) { if (a == 3) a = a - 2; else { a = a - 1; } }\n"
+        "    return a;\n"
+        "}\n";
+    Lexer* heap_lexer = create_lexer(input);
+    Parser* heap_parser = create_parser(heap_lexer);
+    ASTNode* expected = parse_program(heap_parser);
+
+    Lexer* arena_lexer = create_lexer(input);
+    Parser* arena_parser = create_parser(arena_lexer);
+    Arena* arena = create_arena(256);  // small chunks so the tree spans several
+    arena_parser->arena = arena;
+    ASTNode* actual = parse_program(arena_parser);
+
+    check_int_equals(stats, 1, expected != NULL && ast_equal(expected, actual) &&
+                               actual->arena_owned && arena->chunk_count > 1, "arena AST");
+
+    free_ast(expected);
+    free_ast(actual);  // no-op for arena nodes
+    free_arena(arena);
+    free_parser(heap_parser);
+    free_parser(arena_parser);
+    free_lexer(heap_lexer);
+    free_lexer(arena_lexer);
+}
+
+// Renders an expression fully parenthesized, e.g. "(a + (b * 2))"
+static void render_expression(const ASTNode* node, char* out, size_t size) {
+    static const char* ops[] = { "+", "-", "*", "/", "<", ">", "<=", ">=", "==", "!=" };
+    size_t used = strlen(out);
+    if (!node || used + 1 >= size) return;
+    if (node->type == AST_NUMBER) {
+        snprintf(out + used, size - used, "%d", node->value);
+    } else if (node->type == AST_IDENTIFIER) {
+        snprintf(out + used, size - used, "%s", atom_name(node->identifier));
+    } else if (node->type == AST_BINARY_OP) {
+        snprintf(out + used, size - used, "(");
+        render_expression(node->binop.left, out, size);
+        used = strlen(out);
+        snprintf(out + used, size - used, " %s ", ops[node->binop.op_type]);
+        render_expression(node->binop.right, out, size);
+        used = strlen(out);
+        snprintf(out + used, size - used, ")");
+    } else {
+        snprintf(out + used, size - used, "?");
+    }
+}
+
+// Binary operators group by precedence level and associate to the left
+void test_parser_precedence(TestStats* stats) {
+    printf("\nRunning Parser Precedence Tests...\n");
+
+    const char* input =
+        "int main() {\n"
+        "    int a = 1;\n"
+        "    return a - 2 - 3 * a / 4 < 5 + (a - 6) * 7;\n"
+        "}\n";
+    Lexer* lexer = create_lexer(input);
+    Parser* parser = create_parser(lexer);
+    ASTNode* root = parse_program(parser);
+
+    char rendered[256] = "";
+    const ASTNode* function = root && root->block.count == 1 ? root->block.statements[0] : NULL;
+    if (function && function->type == AST_FUNCTION && function->function.body->block.count == 2) {
+        const ASTNode* ret = function->function.body->block.statements[1];
+        if (ret->type == AST_RETURN) render_expression(ret->return_stmt.expr, rendered, sizeof(rendered));
+    }
+
+    if (!check_int_equals(stats, 0, strcmp(rendered, "(((a - 2) - ((3 * a) / 4)) < (5 + ((a - 6) * 7)))"),
+                          "operator precedence")) {
+        printf("  got: %s\n", rendered);
+    }
+
+    free_ast(root);
+    free_parser(parser);
+    free_lexer(lexer);
+}
+
+// A pool node must carry the same kind, position and fields as the tree node
+static int pool_matches(const ASTNode* node, const AstPool* pool, AstRef ref) {
+    if (!node || !ref) return !node && !ref;
+    if (ast_pool_kind(pool, ref) != node->type || ast_pool_offset(pool, ref) != node->loc.offset) return 0;
+    switch (node->type) {
+        case AST_NUMBER: return (int)ast_pool_field(pool, ref, 0) == node->value;
+        case AST_IDENTIFIER: return ast_pool_field(pool, ref, 0) == node->identifier;
+        case AST_BINARY_OP:
+            return ast_pool_op(pool, ref) == node->binop.op_type &&
+                   pool_matches(node->binop.left, pool, ast_pool_field(pool, ref, 0)) &&
+                   pool_matches(node->binop.right, pool, ast_pool_field(pool, ref, 1));
+        case AST_DECLARATION:
+            return ast_pool_field(pool, ref, 0) == node->declaration.name &&
+                   pool_matches(node->declaration.init, pool, ast_pool_field(pool, ref, 1));
+        case AST_ASSIGNMENT:
+            return ast_pool_field(pool, ref, 0) == node->assignment.name &&
+                   pool_matches(node->assignment.value, pool, ast_pool_field(pool, ref, 1));
+        case AST_COMPOUND:
+        case AST_BLOCK:
+        case AST_PROGRAM:
+            if (ast_pool_field(pool, ref, 0) != node->block.count) return 0;
+            for (size_t i = 0; i < node->block.count; ++i) {
+                if (!pool_matches(node->block.statements[i], pool, ast_pool_statement(pool, ref, i))) return 0;
+            }
+            return 1;
+        case AST_IF:
+            return pool_matches(node->if_stmt.condition, pool, ast_pool_field(pool, ref, 0)) &&
+                   pool_matches(node->if_stmt.then_branch, pool, ast_pool_field(pool, ref, 1)) &&
+                   pool_matches(node->if_stmt.else_branch, pool, ast_pool_field(pool, ref, 2));
+        case AST_WHILE:
+            return pool_matches(node->while_stmt.condition, pool, ast_pool_field(pool, ref, 0)) &&
+                   pool_matches(node->while_stmt.body, pool, ast_pool_field(pool, ref, 1));
+        case AST_RETURN: return pool_matches(node->return_stmt.expr, pool, ast_pool_field(pool, ref, 0));
+        case AST_FUNCTION:
+            return ast_pool_field(pool, ref, 0) == node->function.name &&
+                   pool_matches(node->function.body, pool, ast_pool_field(pool, ref, 1));
+    }
+    return 0;
+}
+
+// The compact pool mirrors the tree, in pre-order, in far less memory
+void test_ast_pool(TestStats* stats) {
+    printf("\nRunning AST Pool Tests...\n");
+
+    const char* input =
+        "int main() {\n"
+        "    int a = 2 * (3 + 4);\n"
+        "    if (a >= 10) { a = a / 2; } else a = 0 - a;\n"
+        "    while (a != 1) { int b = a - 1; a = b; }\n"
+        "    return a;\n"
+        "}\n";
+    Lexer* lexer = create_lexer(input);
+    Parser* parser = create_parser(lexer);
+    Arena* arena = create_arena(0);
+    parser->arena = arena;
+    ASTNode* root = parse_program(parser);
+    AstPool* pool = root ? ast_pool_build(root) : NULL;
+
+    // The arena holds one child array per program and block (4) besides the
+    // nodes. Pre-order: each header is followed directly by its first child.
+    AstRef function = pool ? ast_pool_statement(pool, pool->root, 0) : AST_REF_NONE;
+    int ok = pool && pool->root == 1 && pool->nodes == arena->allocations - 4 &&
+             function == pool->root + AST_POOL_HEADER_WORDS + 2 &&
+             ast_pool_field(pool, function, 1) == function + AST_POOL_HEADER_WORDS + 3 &&
+             pool_matches(root, pool, pool->root) &&
+             pool->count * sizeof(uint32_t) * 2 < arena->bytes;
+
+    check_int_equals(stats, 1, ok, "AST pool");
+
+    free_ast_pool(pool);
+    free_arena(arena);
+    free_parser(parser);
+    free_lexer(lexer);
+}
+
+// Several top-level functions parse into one program, in source order
+void test_parser_functions(TestStats* stats) {
+    printf("\nRunning Parser Multiple Functions Tests...\n");
+
+    const char* input =
+        "int first() { return 1; }\n"
+        "int second() { int x = 2; return x; }\n"
+        "int main() { return 3; }\n";
+    Lexer* lexer = create_lexer(input);
+    Parser* parser = create_parser(lexer);
+    ASTNode* root = parse_program(parser);
+
+    int ok = root && root->type == AST_PROGRAM && root->block.count == 3;
+    const char* names[] = { "first", "second", "main" };
+    for (size_t i = 0; ok && i < 3; ++i) {
+        const ASTNode* function = root->block.statements[i];
+        ok = function->type == AST_FUNCTION && strcmp(atom_name(function->function.name), names[i]) == 0;
+    }
+
+    check_int_equals(stats, 1, ok, "multiple functions");
+
+    free_ast(root);
+    free_parser(parser);
+    free_lexer(lexer);
+}
+
+// The generated LALR parser must build the same trees as the recursive-descent
+// one and reject the same programs
+void test_parser_lalr(TestStats* stats) {
+    printf("\nRunning LALR Parser Tests...\n");
+
+    const char* inputs[] = {
+        "int main() {\n"
+        "    int a = 1 + 2 * 3 - (4 - 5) / 6;\n"
+        "    int b = a < 2 == a > 3 + a * (a - 1);\n"
+        "    if (a > 5) if (b) a = 1; else a = 2;\n"
+        "    while (a != 0) { { a = a - 1; } }\n"
+        "    return a;\n"
+        "}\n"
+        "int helper() { int c; c = 7; return c; }\n",
+        "int main() { return 1 }",
+        "int main() { int a = never_declared; return a; }",
+        "int main() { return 1; } int",
+    };
+    int ok = 1;
+    for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); ++i) {
+        Lexer* lexer = create_lexer(inputs[i]);
+        TokenBuffer* tokens = lexer_tokenize(lexer);
+        Parser* descent = create_parser_from_tokens(tokens);
+        Parser* lalr = create_parser_from_tokens(tokens);
+        Arena* arena = create_arena(0);
+        lalr->arena = arena;
+        ASTNode* expected = parse_program(descent);
+        ASTNode* actual = parse_program_lalr(lalr);
+        ok = ok && (i == 0 ? expected != NULL : expected == NULL) && ast_equal(expected, actual) &&
+             lalr->stmt_count == 0;
+        free_ast(expected);
+        free_arena(arena);
+        free_parser(descent);
+        free_parser(lalr);
+        free_token_buffer(tokens);
+        free_lexer(lexer);
+    }
+
+    check_int_equals(stats, 1, ok, "LALR parser");
+}
+
+// Same declared names, in the same order
+static int names_equal(const SymbolTable* a, const SymbolTable* b) {
+    const SymbolEntry* x = a->symbols;
+    const SymbolEntry* y = b->symbols;
+    while (x && y && x->name == y->name) {
+        x = x->next;
+        y = y->next;
+    }
+    return !x && !y;
+}
+
+// Compares a parallel parse of `source` with a sequential one
+static int parallel_matches(const char* source) {
+    Lexer* lexer = create_lexer(source);
+    TokenBuffer* tokens = lexer_tokenize(lexer);
+    Parser* sequential = create_parser_from_tokens(tokens);
+    Parser* parallel = create_parser_from_tokens(tokens);
+    Arena* sequential_arena = create_arena(0);
+    Arena* parallel_arena = create_arena(0);
+    sequential->arena = sequential_arena;
+    parallel->arena = parallel_arena;
+    ASTNode* expected = parse_program(sequential);
+    ASTNode* actual = parse_program_parallel(parallel, 4);
+    int same = ast_equal(expected, actual) && names_equal(sequential->names, parallel->names) &&
+               (!actual || parallel->current_token->type == TOKEN_EOF);
+    free_arena(sequential_arena);
+    free_arena(parallel_arena);
+    free_parser(sequential);
+    free_parser(parallel);
+    free_token_buffer(tokens);
+    free_lexer(lexer);
+    return same;
+}
+
+// Enough definitions for several parallel runs; `last` closes the file
+static char* many_functions(const char* last) {
+    size_t capacity = 1 << 20, length = 0;
+    char* source = malloc(capacity);
+    if (!source) return NULL;
+    length += (size_t)snprintf(source, capacity, "int first() { int first_only = 1; return first_only; }\n");
+    for (int f = 0; f < 2000; ++f) {
+        length += (size_t)snprintf(source + length, capacity - length,
+                                   "int f%d() { int a%d = %d; while (a%d > 0) { a%d = a%d - (1 + 2) * 3; } return a%d; }\n",
+                                   f, f % 7, f, f % 7, f % 7, f % 7, f % 7);
+    }
+    snprintf(source + length, capacity - length, "%s", last);
+    return source;
+}
+
+void test_parser_parallel(TestStats* stats) {
+    printf("\nRunning Parallel Parser Tests...\n");
+
+    const char* cases[] = {
+        "int main() { int b = 1; return b; }\n",
+        "int main() { return first_only; }\n",  // declared in the first run only
+        "int main() { int b = 1 return b; }\n",  // fails sequentially too
+        "int main() { int b = 1; return b; }\n}\n",
+    };
+    const char* names[] = { "parallel parse", "name from an earlier run", "syntax error", "unbalanced brace" };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+        char* source = many_functions(cases[i]);
+        check_int_equals(stats, 1, source && parallel_matches(source), names[i]);
+        free(source);
+    }
+}
+
+// Parses `source` in fused mode on `threads` threads and compares every
+// function's diagnostics and the pool's binding words with what the
+// analyzer's walk of the same tree produces
+static int fused_matches(const char* source, int threads) {
+    Lexer* lexer = create_lexer(source);
+    TokenBuffer* tokens = lexer_tokenize(lexer);
+    Parser* parser = create_parser_from_tokens(tokens);
+    Arena* arena = create_arena(0);
+    parser->arena = arena;
+    int same = parser_enable_semantics(parser);
+    ASTNode* root = same ? parse_program_parallel(parser, threads) : NULL;
+    AstPool* fused = root ? ast_pool_build(root) : NULL;
+    AstPool* walked = root ? ast_pool_build(root) : NULL;
+    same = fused && walked && parser->sema_result_count == ast_pool_field(walked, walked->root, 0);
+    for (size_t i = 0; same && i < parser->sema_result_count; ++i) {
+        const SemanticResult* expected = &parser->sema_results[i];
+        SemanticResult actual;
+        analyze_function_pool(walked, ast_pool_statement(walked, walked->root, i), &actual);
+        same = expected->errors == actual.errors &&
+               (!actual.errors || (expected->first_type == actual.first_type &&
+                                   expected->first_offset == actual.first_offset &&
+                                   strcmp(expected->first_message, actual.first_message) == 0));
+    }
+    same = same && fused->count == walked->count &&
+           memcmp(fused->words, walked->words, fused->count * sizeof(uint32_t)) == 0;
+    free_ast_pool(fused);
+    free_ast_pool(walked);
+    free_arena(arena);
+    free_parser(parser);
+    free_token_buffer(tokens);
+    free_lexer(lexer);
+    return same;
+}
+
+void test_parser_fused(TestStats* stats) {
+    printf("\nRunning Fused Parse Tests...\n");
+
+    const char* cases[] = {
+        "int main() { int a = 1; { int a = a + 1; a = 2; } { int b = a; } return a; }\n",
+        "int main() { int y = y + 1; return z; }\n",  // both are semantic errors now
+        "int main() { { int t = 1; } t = 3; return 0; }\n",  // out of scope
+        "int main() { int a = 1; int a = 2; return a; }\n",
+        "int main() { int x = 1; x = x + 1; }\n",
+        "int main() { return 1; }\nint main() { return 2; }\n",
+    };
+    const char* names[] = { "fused shadowing", "fused undeclared", "fused scope exit", "fused redeclaration",
+                            "fused missing return", "fused function redefinition" };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+        char* source = many_functions(cases[i]);
+        check_int_equals(stats, 1, source && fused_matches(cases[i], 1) && fused_matches(source, 4), names[i]);
+        free(source);
+    }
+}
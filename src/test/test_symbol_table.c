@@ -0,0 +1,59 @@
+#include <stdio.h>
+#include "../utils/scoped_table.h"
+#include "../utils/symbol_table.h"
+#include "test_framework.h"
+
+// Value of the visible binding of `name`, or -1
+static int visible(const ScopedTable* table, Atom name) {
+    const ScopedBinding* binding = scoped_table_lookup(table, name);
+    return binding ? (int)binding->value : -1;
+}
+
+void test_scoped_table(TestStats* stats) {
+    printf("\nRunning Scoped Symbol Table Tests...\n");
+
+    Atom x = intern_cstr("x");
+    Atom y = intern_cstr("y");
+    ScopedTable table;
+    scoped_table_init(&table);
+    scoped_table_push(&table);
+    check_int_equals(stats, 1, scoped_table_insert(&table, x, 1), "declare in outer scope");
+    check_int_equals(stats, 0, scoped_table_insert(&table, x, 2), "redeclaration in same scope");
+
+    scoped_table_push(&table);
+    check_int_equals(stats, 1, scoped_table_insert(&table, x, 3), "shadow in inner scope");
+    check_int_equals(stats, 3, visible(&table, x), "inner binding visible");
+    scoped_table_insert(&table, y, 4);
+    scoped_table_pop(&table);
+    check_int_equals(stats, 1, visible(&table, x), "outer binding restored on pop");
+    check_int_equals(stats, -1, visible(&table, y), "inner name dropped on pop");
+
+    // Enough sibling scopes and names to rehash the slots several times
+    int ok = 1;
+    char name[32];
+    for (int scope = 0; scope < 64; ++scope) {
+        scoped_table_push(&table);
+        for (int i = 0; i < 100; ++i) {
+            snprintf(name, sizeof(name), "s%d_%d", scope, i);
+            if (scoped_table_insert(&table, intern_cstr(name), i) != 1) ok = 0;
+        }
+        if (visible(&table, x) != 1) ok = 0;
+        scoped_table_pop(&table);
+    }
+    check_int_equals(stats, 1, ok, "sibling scopes through rehashing");
+    scoped_table_free(&table);
+
+    // The parser's name table sees names of enclosing tables too
+    SymbolTable* outer = create_symbol_table(NULL);
+    SymbolTable* inner = create_symbol_table(outer);
+    add_symbol(outer, x);
+    for (int i = 0; i < 1000; ++i) {
+        snprintf(name, sizeof(name), "n%d", i);
+        add_symbol(inner, intern_cstr(name));
+    }
+    check_int_equals(stats, 1, lookup_symbol(inner, x), "enclosing table lookup");
+    check_int_equals(stats, 1, lookup_symbol(inner, intern_cstr("n999")), "lookup after index growth");
+    check_int_equals(stats, 0, lookup_symbol(outer, intern_cstr("n0")), "inner names not in outer table");
+    free_symbol_table(inner);
+    free_symbol_table(outer);
+}
@@ -0,0 +1,204 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "../parser/ast.h"
+#include "../parser/ast_pool.h"
+#include "../semantic/semantic_analyzer.h"
+#include "../codegen/asm_generator.h"
+#include "../ir/ir_generator.h"
+#include "test_framework.h"
+
+// Far deeper than any native stack could take one frame per level
+#define DEEP_NESTING 1000000
+
+typedef enum { LEFT_CHAIN, RIGHT_CHAIN, NESTED_CONTROL } NestingShape;
+
+// int main() { int x = 1; <deep statement>; return x; }
+static ASTNode* build_deep_function(Arena* arena, NestingShape shape, size_t depth) {
+    Atom x = intern_cstr("x");
+    ASTNode* one = create_number_node(arena, 1, NULL);
+    ASTNode* deep = NULL;
+    if (shape == NESTED_CONTROL) {
+        // if (x) while (x) if (x) ... x = 1;
+        deep = create_assignment_node(arena, x, one, NULL);
+        for (size_t i = 0; i < depth; ++i) {
+            ASTNode* condition = create_identifier_node(arena, x, NULL);
+            deep = (i & 1) ? create_while_node(arena, condition, deep, NULL)
+                           : create_if_node(arena, condition, deep, NULL, NULL);
+        }
+    } else {
+        // x = ((x + 1) + 1) ... or x = 1 + (1 + (... + x))
+        ASTNode* expr = create_identifier_node(arena, x, NULL);
+        for (size_t i = 0; i < depth; ++i) {
+            expr = shape == LEFT_CHAIN ? create_binop_node(arena, OP_ADD, expr, one, NULL)
+                                       : create_binop_node(arena, OP_ADD, one, expr, NULL);
+        }
+        deep = create_assignment_node(arena, x, expr, NULL);
+    }
+    ASTNode* statements[3] = {
+        create_declaration_node(arena, x, create_number_node(arena, 1, NULL), NULL),
+        deep,
+        create_return_node(arena, create_identifier_node(arena, x, NULL), NULL),
+    };
+    return create_function_node(arena, intern_cstr("main"), create_compound_node(arena, statements, 3), NULL);
+}
+
+// Copies, checks and compiles one deeply nested function
+static int walk_deep_function(NestingShape shape) {
+    Arena* arena = create_arena(0);
+    ASTNode* function = build_deep_function(arena, shape, DEEP_NESTING);
+    AstPool* pool = ast_pool_build(function);
+    int ok = pool != NULL && pool->nodes > DEEP_NESTING;
+
+    SemanticResult result = {0};
+    if (ok) {
+        analyze_function_pool(pool, pool->root, &result);
+        ok = result.errors == 0;
+    }
+
+    for (int backend = CODEGEN_IR; ok && backend <= CODEGEN_AST; ++backend) {
+        AsmGenerator* gen = create_asm_generator(NULL);
+        ok = gen != NULL;
+        if (ok) {
+            gen->backend = (CodegenBackend)backend;
+            generate_function_pool(gen, pool, pool->root);
+            if (shape == NESTED_CONTROL) {
+                // Every if and every while takes two labels
+                ok = count_substrings(gen->buffer, gen->length, ".L") >= 2 * (size_t)DEEP_NESTING;
+            } else if (backend == CODEGEN_AST) {
+                ok = count_substrings(gen->buffer, gen->length, "push rax") == DEEP_NESTING;
+            } else {
+                // One add per operation, plus the one releasing the frame
+                ok = count_substrings(gen->buffer, gen->length, "    add ") == DEEP_NESTING + 1;
+            }
+        }
+        free_asm_generator(gen);
+    }
+
+    FILE* sink = tmpfile();
+    if (ok && sink) {
+        generate_ir_pool(pool, ast_pool_field(pool, pool->root, 1), sink);
+        ok = ftell(sink) > 0;
+    }
+    if (sink) fclose(sink);
+
+    free_ast_pool(pool);
+    free_arena(arena);
+    return ok;
+}
+
+void test_deep_nesting(TestStats* stats) {
+    printf("\nRunning Deep Nesting Traversal Tests...\n");
+
+    const char* names[] = { "deep left binop chain", "deep right binop chain", "deep if/while nesting" };
+    for (int shape = LEFT_CHAIN; shape <= NESTED_CONTROL; ++shape) {
+        check_int_equals(stats, 1, walk_deep_function((NestingShape)shape), names[shape]);
+    }
+
+    // A heap-allocated tree is released node by node
+    ASTNode* chain = create_identifier_node(NULL, intern_cstr("x"), NULL);
+    for (size_t i = 0; chain && i < DEEP_NESTING; ++i) {
+        chain = create_binop_node(NULL, OP_SUB, chain, create_number_node(NULL, 1, NULL), NULL);
+    }
+    check_int_equals(stats, 1, chain != NULL, "deep heap tree built");
+    free_ast(chain);
+}
+
+// Sema binds every name to its declaration's frame slot; sibling blocks share slots
+void test_frame_slots(TestStats* stats) {
+    printf("\nRunning Frame Slot Binding Tests...\n");
+
+    Arena* arena = create_arena(0);
+    Atom a = intern_cstr("a"), b = intern_cstr("b"), c = intern_cstr("c");
+    // int main() { int a = 1; { int b = a; a = b; } { int c = 2; } return a; }
+    ASTNode* first[] = {
+        create_declaration_node(arena, b, create_identifier_node(arena, a, NULL), NULL),
+        create_assignment_node(arena, a, create_identifier_node(arena, b, NULL), NULL),
+    };
+    ASTNode* second[] = { create_declaration_node(arena, c, create_number_node(arena, 2, NULL), NULL) };
+    ASTNode* body[] = {
+        create_declaration_node(arena, a, create_number_node(arena, 1, NULL), NULL),
+        create_compound_node(arena, first, 2),
+        create_compound_node(arena, second, 1),
+        create_return_node(arena, create_identifier_node(arena, a, NULL), NULL),
+    };
+    ASTNode* function = create_function_node(arena, intern_cstr("main"), create_compound_node(arena, body, 4), NULL);
+    AstPool* pool = ast_pool_build(function);
+
+    int ok = pool != NULL;
+    if (ok) {
+        SemanticResult result = {0};
+        analyze_function_pool(pool, pool->root, &result);
+        AstRef block = ast_pool_field(pool, pool->root, 1);
+        AstRef inner = ast_pool_statement(pool, block, 1);
+        AstRef decl_b = ast_pool_statement(pool, inner, 0);
+        AstRef assign_a = ast_pool_statement(pool, inner, 1);
+        AstRef decl_c = ast_pool_statement(pool, ast_pool_statement(pool, block, 2), 0);
+        ok = result.errors == 0 && ast_pool_field(pool, pool->root, 2) == 2 &&
+             ast_pool_slot(pool, ast_pool_statement(pool, block, 0)) == 0 &&
+             ast_pool_slot(pool, ast_pool_field(pool, decl_b, 1)) == 0 && ast_pool_slot(pool, decl_b) == 1 &&
+             ast_pool_slot(pool, assign_a) == 0 && ast_pool_slot(pool, ast_pool_field(pool, assign_a, 1)) == 1 &&
+             ast_pool_slot(pool, decl_c) == 1;
+    }
+    AsmGenerator* gen = ok ? create_asm_generator(NULL) : NULL;
+    if (gen) {
+        generate_function_pool(gen, pool, pool->root);
+        ok = count_substrings(gen->buffer, gen->length, "sub rsp, 16") == 1 &&
+             count_substrings(gen->buffer, gen->length, "[rel a]") == 0;
+    }
+    check_int_equals(stats, 1, ok, "frame slots");
+    free_asm_generator(gen);
+    free_ast_pool(pool);
+    free_arena(arena);
+}
+
+// IR operands are tagged 32-bit values: temps, variable slots, immediates, labels
+void test_ir_operands(TestStats* stats) {
+    printf("\nRunning IR Operand Tests...\n");
+
+    Arena* arena = create_arena(0);
+    Atom a = intern_cstr("a");
+    // int main() { int a = 2147483647; while (a > 0) { a = a - 1; } return a; }
+    ASTNode* loop_body[] = {
+        create_assignment_node(arena, a, create_binop_node(arena, OP_SUB, create_identifier_node(arena, a, NULL),
+                                                           create_number_node(arena, 1, NULL), NULL), NULL),
+    };
+    ASTNode* body[] = {
+        create_declaration_node(arena, a, create_number_node(arena, 2147483647, NULL), NULL),
+        create_while_node(arena, create_binop_node(arena, OP_GT, create_identifier_node(arena, a, NULL),
+                                                   create_number_node(arena, 0, NULL), NULL),
+                          create_compound_node(arena, loop_body, 1), NULL),
+        create_return_node(arena, create_identifier_node(arena, a, NULL), NULL),
+    };
+    ASTNode* function = create_function_node(arena, intern_cstr("main"), create_compound_node(arena, body, 3), NULL);
+    AstPool* pool = ast_pool_build(function);
+    IRProgram program = {0};
+
+    int ok = pool != NULL && sizeof(IRInstruction) == 16;
+    if (ok) {
+        SemanticResult result = {0};
+        analyze_function_pool(pool, pool->root, &result);
+        ok = result.errors == 0 && generate_ir_program(pool, ast_pool_field(pool, pool->root, 1), &program);
+    }
+    // t0 = 2147483647; v0 = t0; L0: t1 = v0; t2 = 0; t3 = t1 > t2; ifnot t3 goto L1;
+    // t4 = v0; t5 = 1; t6 = t4 - t5; v0 = t6; goto L0; L1: t7 = v0; return t7
+    if (ok && program.count == 15) {
+        const IRInstruction* code = program.code;
+        ok = code[0].type == IR_LOAD_CONST && code[0].kinds[1] == IR_OPERAND_IMM &&
+             code[0].operands[1] == 2147483647 &&
+             code[1].type == IR_ASSIGN && code[1].kinds[0] == IR_OPERAND_VAR && code[1].operands[0] == 0 &&
+             code[1].kinds[1] == IR_OPERAND_TEMP && code[1].operands[1] == 0 &&
+             code[6].type == IR_JUMP_IF_FALSE && code[6].kinds[0] == IR_OPERAND_BLOCK &&
+             code[6].operands[0] == 1 && code[6].operands[1] == 3 &&
+             code[9].type == IR_SUB && code[9].operands[0] == 6 && code[9].operands[1] == 4 &&
+             code[9].operands[2] == 5 && code[9].kinds[2] == IR_OPERAND_TEMP &&
+             code[12].type == IR_LABEL && code[12].operands[0] == 1 &&
+             code[14].type == IR_RETURN && code[14].operands[1] == 7 &&
+             program.temp_count == 8 && program.block_count == 2;
+    } else {
+        ok = 0;
+    }
+    check_int_equals(stats, 1, ok, "IR operands");
+    free_ir_program(&program);
+    free_ast_pool(pool);
+    free_arena(arena);
+}
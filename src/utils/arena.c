@@ -0,0 +1,66 @@
+#include "arena.h"
+#include <stdlib.h>
+
+#define ARENA_ALIGN (sizeof(max_align_t))
+
+Arena* create_arena(size_t chunk_size) {
+    Arena* arena = malloc(sizeof(Arena));
+    if (!arena) return NULL;
+    arena->head = NULL;
+    arena->chunk_size = chunk_size ? chunk_size : ARENA_DEFAULT_CHUNK_SIZE;
+    arena->chunk_count = 0;
+    arena->allocations = 0;
+    arena->bytes = 0;
+    return arena;
+}
+
+void* arena_alloc(Arena* arena, size_t size) {
+    size = (size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+    ArenaChunk* chunk = arena->head;
+    if (!chunk || chunk->capacity - chunk->used < size) {
+        // Oversized requests get a chunk of their own
+        size_t capacity = size > arena->chunk_size ? size : arena->chunk_size;
+        chunk = malloc(sizeof(ArenaChunk) + capacity);
+        if (!chunk) return NULL;
+        chunk->next = arena->head;
+        chunk->used = 0;
+        chunk->capacity = capacity;
+        arena->head = chunk;
+        arena->chunk_count++;
+    }
+    void* block = (char*)chunk->data + chunk->used;
+    chunk->used += size;
+    arena->allocations++;
+    arena->bytes += size;
+    return block;
+}
+
+void arena_merge(Arena* into, Arena* from) {
+    if (!from) return;
+    if (from->head) {
+        // Splice the chunks in behind `into`'s head, which keeps filling
+        ArenaChunk* tail = from->head;
+        while (tail->next) tail = tail->next;
+        if (into->head) {
+            tail->next = into->head->next;
+            into->head->next = from->head;
+        } else {
+            into->head = from->head;
+        }
+    }
+    into->chunk_count += from->chunk_count;
+    into->allocations += from->allocations;
+    into->bytes += from->bytes;
+    free(from);
+}
+
+void free_arena(Arena* arena) {
+    if (!arena) return;
+    ArenaChunk* chunk = arena->head;
+    while (chunk) {
+        ArenaChunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    free(arena);
+}
@@ -0,0 +1,33 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+// Bump allocator with chained chunks. Allocation is a pointer increment;
+// individual blocks are never freed, the whole arena is released at once.
+// Used for data that lives exactly as long as one compilation, like the AST.
+typedef struct ArenaChunk {
+    struct ArenaChunk* next;
+    size_t used;
+    size_t capacity;
+    max_align_t data[];
+} ArenaChunk;
+
+typedef struct Arena {
+    ArenaChunk* head;     // chunk currently being filled
+    size_t chunk_size;    // default capacity of new chunks
+    size_t chunk_count;   // chunks obtained from malloc (one free each at teardown)
+    size_t allocations;   // blocks handed out
+    size_t bytes;         // bytes handed out, including alignment padding
+} Arena;
+
+#define ARENA_DEFAULT_CHUNK_SIZE (64 * 1024)
+
+Arena* create_arena(size_t chunk_size);  // 0 selects ARENA_DEFAULT_CHUNK_SIZE
+void* arena_alloc(Arena* arena, size_t size);  // aligned for any type; NULL if out of memory
+// Moves every chunk of `from` into `into` and frees `from`. Blocks of both
+// stay where they are and are released together by free_arena(into).
+void arena_merge(Arena* into, Arena* from);
+void free_arena(Arena* arena);
+
+#endif // ARENA_H
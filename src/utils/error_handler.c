@@ -22,10 +22,24 @@ const char* get_error_type_string(ErrorType type) {
     }
 }
 
-void report_error(ErrorType type, int line, int column, const char* format, ...) {
-    va_list args;
-    va_start(args, format);
-    
+static LineIndex* error_source = NULL;
+
+void set_error_source(LineIndex* lines) {
+    error_source = lines;
+}
+
+static void resolve_offset(size_t offset, int* line, int* column) {
+    *line = 0;
+    *column = 0;
+    if (error_source && offset != SOURCE_OFFSET_NONE) {
+        size_t l, c;
+        line_index_resolve(error_source, offset, &l, &c);
+        *line = (int)l;
+        *column = (int)c;
+    }
+}
+
+static void vreport_error(ErrorType type, int line, int column, const char* format, va_list args) {
     fprintf(stderr, "\033[1;31m%s\033[0m at line %d, column %d: ", 
             get_error_type_string(type), line, column);
     vfprintf(stderr, format, args);
@@ -33,18 +47,51 @@ void report_error(ErrorType type, int line, int column, const char* format, ...)
     
     // Print the source line with error indicator (if source line is available)
     // This could be implemented by storing source lines in a buffer
-    
+}
+
+static void vreport_warning(int line, int column, const char* format, va_list args) {
+    fprintf(stderr, "\033[1;33mWarning\033[0m at line %d, column %d: ", line, column);
+    vfprintf(stderr, format, args);
+    fprintf(stderr, "\n");
+}
+
+void report_error(ErrorType type, int line, int column, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    vreport_error(type, line, column, format, args);
     va_end(args);
     exit(1);
 }
 
+void report_error_nonfatal(ErrorType type, int line, int column, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    vreport_error(type, line, column, format, args);
+    va_end(args);
+}
+
 void report_warning(int line, int column, const char* format, ...) {
     va_list args;
     va_start(args, format);
-    
-    fprintf(stderr, "\033[1;33mWarning\033[0m at line %d, column %d: ", line, column);
-    vfprintf(stderr, format, args);
-    fprintf(stderr, "\n");
-    
+    vreport_warning(line, column, format, args);
+    va_end(args);
+}
+
+void report_error_at(ErrorType type, size_t offset, const char* format, ...) {
+    int line, column;
+    resolve_offset(offset, &line, &column);
+    va_list args;
+    va_start(args, format);
+    vreport_error(type, line, column, format, args);
+    va_end(args);
+    exit(1);
+}
+
+void report_warning_at(size_t offset, const char* format, ...) {
+    int line, column;
+    resolve_offset(offset, &line, &column);
+    va_list args;
+    va_start(args, format);
+    vreport_warning(line, column, format, args);
     va_end(args);
 }
\ No newline at end of file
@@ -1,6 +1,9 @@
 #ifndef ERROR_HANDLER_H
 #define ERROR_HANDLER_H
 
+#include <stddef.h>
+#include "line_index.h"
+
 // Error types enum for specific error categorization
 typedef enum {
     ERROR_LEXICAL,
@@ -14,9 +17,19 @@ typedef enum {
 // Function to report errors with line, column, and error type information
 void report_error(ErrorType type, int line, int column, const char* format, ...);
 
+// Same report as report_error, but returns instead of exiting (for --watch)
+void report_error_nonfatal(ErrorType type, int line, int column, const char* format, ...);
+
 // Function to report warnings with line, column, and specific warning information
 void report_warning(int line, int column, const char* format, ...);
 
+// Offset-based variants: the position is resolved through the line index
+// registered with set_error_source, only when a diagnostic is emitted.
+// An offset of SOURCE_OFFSET_NONE, or no registered index, reports line 0, column 0.
+void set_error_source(LineIndex* lines);
+void report_error_at(ErrorType type, size_t offset, const char* format, ...);
+void report_warning_at(size_t offset, const char* format, ...);
+
 // Function to get error type string representation
 const char* get_error_type_string(ErrorType type);
 
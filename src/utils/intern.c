@@ -0,0 +1,138 @@
+#include "intern.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Names live in chunked storage and atom -> name pointers in fixed-size
+// pages, so neither ever moves once handed out.
+#define NAME_CHUNK_SIZE (64 * 1024)
+#define ATOM_PAGE_BITS 12
+#define ATOM_PAGE_SIZE (1u << ATOM_PAGE_BITS)
+#define ATOM_MAX_PAGES (1u << 16)
+
+typedef struct NameChunk {
+    struct NameChunk* next;
+    size_t used;
+    size_t capacity;
+    char data[];
+} NameChunk;
+
+typedef struct {
+    uint32_t hash;
+    Atom atom;  // ATOM_NONE marks an empty slot
+    size_t length;
+} InternSlot;
+
+static NameChunk* name_chunks = NULL;
+static const char** atom_pages[ATOM_MAX_PAGES];
+static uint32_t atom_total = 0;
+
+static InternSlot* slots = NULL;
+static uint32_t slot_mask = 0;  // capacity - 1, capacity is a power of two
+
+uint32_t intern_hash(const char* text, size_t length) {
+    uint32_t h = 2166136261u;  // FNV-1a
+    for (size_t i = 0; i < length; ++i) {
+        h ^= (unsigned char)text[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static char* store_name(const char* text, size_t length) {
+    if (!name_chunks || name_chunks->capacity - name_chunks->used < length + 1) {
+        size_t capacity = length + 1 > NAME_CHUNK_SIZE ? length + 1 : NAME_CHUNK_SIZE;
+        NameChunk* chunk = malloc(sizeof(NameChunk) + capacity);
+        if (!chunk) return NULL;
+        chunk->next = name_chunks;
+        chunk->used = 0;
+        chunk->capacity = capacity;
+        name_chunks = chunk;
+    }
+    char* name = name_chunks->data + name_chunks->used;
+    memcpy(name, text, length);
+    name[length] = '\0';
+    name_chunks->used += length + 1;
+    return name;
+}
+
+// Keeps the current table if the larger one cannot be allocated
+static int grow_slots(void) {
+    uint32_t old_capacity = slots ? slot_mask + 1 : 0;
+    uint32_t capacity = old_capacity ? old_capacity * 2 : 1024;
+    InternSlot* old = slots;
+    InternSlot* grown = calloc(capacity, sizeof(InternSlot));
+    if (!grown) return 0;
+    slots = grown;
+    slot_mask = capacity - 1;
+    for (uint32_t i = 0; i < old_capacity; ++i) {
+        if (old[i].atom == ATOM_NONE) continue;
+        uint32_t j = old[i].hash & slot_mask;
+        while (slots[j].atom != ATOM_NONE) j = (j + 1) & slot_mask;
+        slots[j] = old[i];
+    }
+    free(old);
+    return 1;
+}
+
+Atom intern(const char* text, size_t length) {
+    return intern_hashed(text, length, intern_hash(text, length));
+}
+
+Atom intern_hashed(const char* text, size_t length, uint32_t hash) {
+    // Keep the load factor at or below 1/2
+    if ((!slots || (atom_total + 1) * 2 > slot_mask + 1) && !grow_slots()) return ATOM_NONE;
+
+    uint32_t i = hash & slot_mask;
+    while (slots[i].atom != ATOM_NONE) {
+        if (slots[i].hash == hash && slots[i].length == length &&
+            memcmp(atom_name(slots[i].atom), text, length) == 0) {
+            return slots[i].atom;
+        }
+        i = (i + 1) & slot_mask;
+    }
+
+    Atom atom = atom_total + 1;
+    uint32_t page = atom >> ATOM_PAGE_BITS;
+    if (page >= ATOM_MAX_PAGES) return ATOM_NONE;
+    if (!atom_pages[page]) {
+        atom_pages[page] = calloc(ATOM_PAGE_SIZE, sizeof(const char*));
+        if (!atom_pages[page]) return ATOM_NONE;
+    }
+    char* name = store_name(text, length);
+    if (!name) return ATOM_NONE;
+    atom_pages[page][atom & (ATOM_PAGE_SIZE - 1)] = name;
+    atom_total = atom;
+    slots[i].hash = hash;
+    slots[i].atom = atom;
+    slots[i].length = length;
+    return atom;
+}
+
+Atom intern_cstr(const char* text) {
+    return intern(text, strlen(text));
+}
+
+const char* atom_name(Atom atom) {
+    if (atom == ATOM_NONE || atom > atom_total) return "(null)";
+    return atom_pages[atom >> ATOM_PAGE_BITS][atom & (ATOM_PAGE_SIZE - 1)];
+}
+
+uint32_t atom_count(void) {
+    return atom_total;
+}
+
+void free_intern_table(void) {
+    while (name_chunks) {
+        NameChunk* next = name_chunks->next;
+        free(name_chunks);
+        name_chunks = next;
+    }
+    for (uint32_t page = 0; page < ATOM_MAX_PAGES && atom_pages[page]; ++page) {
+        free(atom_pages[page]);
+        atom_pages[page] = NULL;
+    }
+    free(slots);
+    slots = NULL;
+    slot_mask = 0;
+    atom_total = 0;
+}
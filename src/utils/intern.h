@@ -0,0 +1,40 @@
+#ifndef INTERN_H
+#define INTERN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Global string interning (atom table). Every distinct identifier is stored
+// once and represented by a small integer, so names compare with == and can
+// index arrays directly. The lexer interns identifiers as it scans them;
+// later phases never hash a name again.
+typedef uint32_t Atom;
+
+#define ATOM_NONE 0  // returned by intern() only when out of memory
+
+Atom intern(const char* text, size_t length);
+Atom intern_cstr(const char* text);
+
+// intern() split in two: the hash is a pure function of the text and may be
+// computed on any thread, while intern_hashed() updates the table and must
+// only be called from one thread at a time.
+uint32_t intern_hash(const char* text, size_t length);
+Atom intern_hashed(const char* text, size_t length, uint32_t hash);
+
+// NUL-terminated spelling of an atom; the pointer stays valid until
+// free_intern_table() is called.
+const char* atom_name(Atom atom);
+
+// Start slot of `atom` in a power-of-two hash table of mask + 1 slots.
+// Multiplying by an odd constant keeps distinct atoms in distinct slots of
+// a table larger than their spread, and scatters runs of consecutive atoms.
+static inline uint32_t atom_slot(Atom atom, uint32_t mask) {
+    return (atom * 2654435769u) & mask;
+}
+
+// Number of atoms interned so far (valid atoms are 1..atom_count())
+uint32_t atom_count(void);
+
+void free_intern_table(void);
+
+#endif // INTERN_H
@@ -0,0 +1,55 @@
+#include "line_index.h"
+#include <stdlib.h>
+#include <string.h>
+
+void line_index_init(LineIndex* index, const char* text, size_t length) {
+    index->starts = NULL;  // allocated when the first newline is indexed
+    index->count = 0;
+    index->capacity = 0;
+    index->scanned = 0;
+    index->text = text;
+    index->length = length;
+}
+
+void line_index_feed(LineIndex* index, const char* p, size_t n) {
+    size_t base = index->scanned;
+    const char* start = p;
+    const char* end = p + n;
+    const char* nl;
+    // memchr is vectorized by the C library, so sparse newlines are cheap
+    while (p < end && (nl = memchr(p, '\n', (size_t)(end - p))) != NULL) {
+        if (index->count == index->capacity) {
+            index->capacity = index->capacity ? index->capacity * 2 : 64;
+            index->starts = realloc(index->starts, index->capacity * sizeof(size_t));
+        }
+        index->starts[index->count++] = base + (size_t)(nl + 1 - start);
+        p = nl + 1;
+    }
+    index->scanned = base + n;
+}
+
+void line_index_resolve(LineIndex* index, size_t offset, size_t* line, size_t* column) {
+    if (index->text && offset > index->scanned && index->scanned < index->length) {
+        size_t upto = offset < index->length ? offset : index->length;
+        line_index_feed(index, index->text + index->scanned, upto - index->scanned);
+    }
+
+    // Number of lines after the first that start at or before offset
+    size_t lo = 0, hi = index->count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (index->starts[mid] <= offset) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    *line = lo + 1;
+    *column = offset - (lo ? index->starts[lo - 1] : 0) + 1;
+}
+
+void free_line_index(LineIndex* index) {
+    free(index->starts);
+    index->starts = NULL;
+    index->count = index->capacity = 0;
+}
@@ -0,0 +1,33 @@
+#ifndef LINE_INDEX_H
+#define LINE_INDEX_H
+
+#include <stddef.h>
+
+// Maps byte offsets to 1-based line/column pairs. Tokens and AST nodes only
+// carry offsets; positions are resolved here on the diagnostic path.
+//
+// A whole-buffer index is built lazily: the first lookup scans the source
+// for newlines up to the requested offset. A streaming lexer cannot revisit
+// discarded bytes, so it feeds each chunk as it is read instead.
+typedef struct LineIndex {
+    size_t* starts;      // starts[i] is the offset of the first byte of line i + 2
+    size_t count;        // lines after the first one found so far
+    size_t capacity;
+    size_t scanned;      // bytes [0, scanned) have been indexed
+    const char* text;    // whole-buffer source, NULL when fed chunk by chunk
+    size_t length;
+} LineIndex;
+
+#define SOURCE_OFFSET_NONE ((size_t)-1)  // offset of something with no source position
+
+void line_index_init(LineIndex* index, const char* text, size_t length);
+
+// Indexes the newlines in p[0, n), which must start at offset index->scanned
+void line_index_feed(LineIndex* index, const char* p, size_t n);
+
+// Column counts bytes from the start of the line, starting at 1
+void line_index_resolve(LineIndex* index, size_t offset, size_t* line, size_t* column);
+
+void free_line_index(LineIndex* index);
+
+#endif // LINE_INDEX_H
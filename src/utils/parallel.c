@@ -0,0 +1,87 @@
+#include "parallel.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+typedef struct ParallelJob {
+    ParallelTask task;
+    void* context;
+    size_t count;
+    atomic_size_t next;  // next index to hand out
+} ParallelJob;
+
+static void run_tasks(ParallelJob* job) {
+    size_t i;
+    while ((i = atomic_fetch_add_explicit(&job->next, 1, memory_order_relaxed)) < job->count) {
+        job->task(job->context, i);
+    }
+}
+
+#ifdef _WIN32
+static DWORD WINAPI worker_thread(LPVOID arg) {
+    run_tasks(arg);
+    return 0;
+}
+#else
+static void* worker_thread(void* arg) {
+    run_tasks(arg);
+    return NULL;
+}
+#endif
+
+int parallel_cpu_count(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+#endif
+}
+
+void parallel_for(size_t count, int threads, ParallelTask task, void* context) {
+    if (threads <= 0) threads = parallel_cpu_count();
+    if ((size_t)threads > count) threads = (int)count;
+
+    ParallelJob job;
+    job.task = task;
+    job.context = context;
+    job.count = count;
+    atomic_init(&job.next, 0);
+    if (threads <= 1) {
+        run_tasks(&job);
+        return;
+    }
+
+#ifdef _WIN32
+    HANDLE* handles = malloc((size_t)threads * sizeof(HANDLE));
+    int started = 0;
+    while (handles && started < threads - 1 &&
+           (handles[started] = CreateThread(NULL, 0, worker_thread, &job, 0, NULL))) {
+        started++;
+    }
+    run_tasks(&job);
+    for (int t = 0; t < started; ++t) {
+        WaitForSingleObject(handles[t], INFINITE);
+        CloseHandle(handles[t]);
+    }
+    free(handles);
+#else
+    pthread_t* handles = malloc((size_t)threads * sizeof(pthread_t));
+    int started = 0;
+    while (handles && started < threads - 1 &&
+           pthread_create(&handles[started], NULL, worker_thread, &job) == 0) {
+        started++;
+    }
+    run_tasks(&job);
+    for (int t = 0; t < started; ++t) pthread_join(handles[t], NULL);
+    free(handles);
+#endif
+}
@@ -0,0 +1,17 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <stddef.h>
+
+// Minimal fork/join thread pool. parallel_for() runs task(context, i) for
+// every i in [0, count) on up to `threads` threads (<= 0 selects one per
+// CPU) and returns once all tasks have finished. Indices are handed out one
+// at a time in increasing order, so tasks of uneven size still balance. The
+// calling thread works too; if a thread cannot be started its share simply
+// runs on the others.
+typedef void (*ParallelTask)(void* context, size_t index);
+
+void parallel_for(size_t count, int threads, ParallelTask task, void* context);
+int parallel_cpu_count(void);
+
+#endif // PARALLEL_H
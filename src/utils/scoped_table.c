@@ -0,0 +1,118 @@
+#include "scoped_table.h"
+#include <stdlib.h>
+
+#define SCOPED_MIN_SLOTS 64
+
+void scoped_table_init(ScopedTable* table) {
+    table->slots = NULL;
+    table->slot_capacity = 0;
+    table->slot_count = 0;
+    table->bindings = NULL;
+    table->binding_count = 0;
+    table->binding_capacity = 0;
+    table->binding_peak = 0;
+    table->marks = NULL;
+    table->depth = 0;
+    table->mark_capacity = 0;
+}
+
+void scoped_table_free(ScopedTable* table) {
+    free(table->slots);
+    free(table->bindings);
+    free(table->marks);
+    scoped_table_init(table);
+}
+
+// Slot holding `name`, or the empty slot where it would go; linear probing
+static ScopedSlot* find_slot(const ScopedTable* table, Atom name) {
+    uint32_t mask = (uint32_t)(table->slot_capacity - 1);
+    uint32_t i = atom_slot(name, mask);
+    while (table->slots[i].name != name && table->slots[i].name != ATOM_NONE) i = (i + 1) & mask;
+    return &table->slots[i];
+}
+
+// Rehashes the names still in scope into a table at most 3/8 full; names
+// that went out of scope are dropped on the way
+static int rehash_slots(ScopedTable* table) {
+    ScopedSlot* old = table->slots;
+    size_t old_capacity = table->slot_capacity;
+    size_t live = 1;  // the name about to be inserted
+    for (size_t i = 0; i < old_capacity; ++i) live += old[i].name != ATOM_NONE && old[i].binding != SCOPED_NONE;
+    size_t capacity = SCOPED_MIN_SLOTS;
+    while (capacity * 3 < live * 8) capacity *= 2;
+    table->slots = calloc(capacity, sizeof(ScopedSlot));
+    if (!table->slots) {
+        table->slots = old;
+        return 0;
+    }
+    table->slot_capacity = capacity;
+    table->slot_count = 0;
+    for (size_t i = 0; i < old_capacity; ++i) {
+        if (old[i].name == ATOM_NONE || old[i].binding == SCOPED_NONE) continue;
+        *find_slot(table, old[i].name) = old[i];
+        table->slot_count++;
+    }
+    free(old);
+    return 1;
+}
+
+int scoped_table_push(ScopedTable* table) {
+    if (table->depth == table->mark_capacity) {
+        size_t capacity = table->mark_capacity ? table->mark_capacity * 2 : 16;
+        size_t* grown = realloc(table->marks, capacity * sizeof(size_t));
+        if (!grown) return 0;
+        table->marks = grown;
+        table->mark_capacity = capacity;
+    }
+    table->marks[table->depth++] = table->binding_count;
+    return 1;
+}
+
+void scoped_table_pop(ScopedTable* table) {
+    if (table->depth == 0) return;
+    size_t mark = table->marks[--table->depth];
+    while (table->binding_count > mark) {
+        const ScopedBinding* binding = &table->bindings[--table->binding_count];
+        find_slot(table, binding->name)->binding = binding->shadowed;
+    }
+}
+
+int scoped_table_insert(ScopedTable* table, Atom name, uint32_t value) {
+    // Keep the load factor under 3/4
+    if ((table->slot_count + 1) * 4 > table->slot_capacity * 3 && !rehash_slots(table)) return -1;
+    if (table->binding_count == table->binding_capacity) {
+        size_t capacity = table->binding_capacity ? table->binding_capacity * 2 : 64;
+        if (capacity > SCOPED_NONE) return -1;
+        ScopedBinding* grown = realloc(table->bindings, capacity * sizeof(ScopedBinding));
+        if (!grown) return -1;
+        table->bindings = grown;
+        table->binding_capacity = capacity;
+    }
+
+    ScopedSlot* slot = find_slot(table, name);
+    uint32_t shadowed = SCOPED_NONE;
+    if (slot->name == ATOM_NONE) {
+        slot->name = name;
+        slot->binding = SCOPED_NONE;
+        table->slot_count++;
+    } else if (slot->binding != SCOPED_NONE) {
+        if (table->bindings[slot->binding].depth == table->depth) return 0;
+        shadowed = slot->binding;
+    }
+
+    ScopedBinding* binding = &table->bindings[table->binding_count];
+    binding->name = name;
+    binding->depth = (uint32_t)table->depth;
+    binding->shadowed = shadowed;
+    binding->value = value;
+    slot->binding = (uint32_t)table->binding_count++;
+    if (table->binding_count > table->binding_peak) table->binding_peak = table->binding_count;
+    return 1;
+}
+
+const ScopedBinding* scoped_table_lookup(const ScopedTable* table, Atom name) {
+    if (!table->slots) return NULL;
+    const ScopedSlot* slot = find_slot(table, name);
+    if (slot->name == ATOM_NONE || slot->binding == SCOPED_NONE) return NULL;
+    return &table->bindings[slot->binding];
+}
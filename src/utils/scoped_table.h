@@ -0,0 +1,61 @@
+#ifndef SCOPED_TABLE_H
+#define SCOPED_TABLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "intern.h"
+
+// Block-scoped name table for checking one function. An open-addressing hash
+// table maps each atom to its innermost visible binding. Bindings are kept
+// in declaration order in an undo log, each remembering the binding it
+// shadows, so leaving a scope just rewinds the log to where the scope began
+// and restores the shadowed bindings: O(1) per declaration, and no per-scope
+// allocation. Lookups and redeclaration checks are one probe sequence.
+//
+// A binding's index in the log is the number of bindings live when it was
+// declared, so it can serve as a frame slot: sibling scopes reuse the same
+// slots, and binding_peak is the number of slots needed.
+#define SCOPED_NONE UINT32_MAX
+
+typedef struct ScopedBinding {
+    Atom name;
+    uint32_t depth;     // scope the name was declared in (1 = outermost)
+    uint32_t shadowed;  // binding hidden by this one, or SCOPED_NONE
+    uint32_t value;     // caller's data for the name
+} ScopedBinding;
+
+typedef struct ScopedSlot {
+    Atom name;          // ATOM_NONE marks an empty slot
+    uint32_t binding;   // innermost binding, SCOPED_NONE once out of scope
+} ScopedSlot;
+
+typedef struct ScopedTable {
+    ScopedSlot* slots;
+    size_t slot_capacity;       // power of two, or 0 before the first declaration
+    size_t slot_count;          // slots holding a name
+    ScopedBinding* bindings;    // undo log, innermost scope last
+    size_t binding_count;
+    size_t binding_capacity;
+    size_t binding_peak;        // most bindings live at once
+    size_t* marks;              // binding_count when each open scope began
+    size_t depth;               // open scopes
+    size_t mark_capacity;
+} ScopedTable;
+
+void scoped_table_init(ScopedTable* table);
+void scoped_table_free(ScopedTable* table);
+
+// Opens a scope; returns 0 if out of memory
+int scoped_table_push(ScopedTable* table);
+// Closes the innermost scope, dropping the names it declared
+void scoped_table_pop(ScopedTable* table);
+
+// Declares `name` in the innermost scope. Returns 1, 0 if that scope already
+// declares it, or -1 if out of memory.
+int scoped_table_insert(ScopedTable* table, Atom name, uint32_t value);
+
+// Innermost visible binding of `name`, or NULL. The pointer is valid until
+// the table next changes.
+const ScopedBinding* scoped_table_lookup(const ScopedTable* table, Atom name);
+
+#endif // SCOPED_TABLE_H
@@ -1,32 +1,64 @@
 #include "symbol_table.h"
 #include <stdlib.h>
-#include <string.h>
 #include <stdio.h>
 
-SymbolTable* symbol_table = NULL; // Define the global symbol_table
+#define SYMBOL_INDEX_MIN_SLOTS 64
 
 SymbolTable* create_symbol_table(SymbolTable* parent) {
     SymbolTable* table = malloc(sizeof(SymbolTable));
+    if (!table) return NULL;
     table->parent = parent;
     table->symbols = NULL;
+    table->index = NULL;
+    table->index_capacity = 0;
+    table->count = 0;
     return table;
 }
 
-bool insert_symbol(SymbolTable* table, const char* name) {
+// Slot holding `name` in a table's index, or the empty slot where it goes
+static Atom* index_slot(const SymbolTable* table, Atom name) {
+    uint32_t mask = (uint32_t)(table->index_capacity - 1);
+    uint32_t i = atom_slot(name, mask);
+    while (table->index[i] != name && table->index[i] != ATOM_NONE) i = (i + 1) & mask;
+    return &table->index[i];
+}
+
+static bool grow_index(SymbolTable* table) {
+    Atom* old = table->index;
+    size_t old_capacity = table->index_capacity;
+    size_t capacity = old_capacity ? old_capacity * 2 : SYMBOL_INDEX_MIN_SLOTS;
+    table->index = calloc(capacity, sizeof(Atom));
+    if (!table->index) {
+        table->index = old;
+        return false;
+    }
+    table->index_capacity = capacity;
+    for (size_t i = 0; i < old_capacity; ++i) {
+        if (old[i] != ATOM_NONE) *index_slot(table, old[i]) = old[i];
+    }
+    free(old);
+    return true;
+}
+
+bool insert_symbol(SymbolTable* table, Atom name) {
+    // Keep the index under 3/4 full
+    if ((table->count + 1) * 4 > table->index_capacity * 3 && !grow_index(table)) return false;
     SymbolEntry* entry = malloc(sizeof(SymbolEntry));
-    entry->name = strdup(name);
+    if (!entry) return false;
+    entry->name = name;
     entry->next = table->symbols;
     table->symbols = entry;
+    Atom* slot = index_slot(table, name);
+    if (*slot == ATOM_NONE) {
+        *slot = name;
+        table->count++;
+    }
     return true;
 }
 
-bool lookup_symbol(SymbolTable* table, const char* name) {
+bool lookup_symbol(SymbolTable* table, Atom name) {
     for (SymbolTable* t = table; t != NULL; t = t->parent) {
-        for (SymbolEntry* e = t->symbols; e != NULL; e = e->next) {
-            if (strcmp(e->name, name) == 0) {
-                return true;
-            }
-        }
+        if (t->index_capacity && *index_slot(t, name) == name) return true;
     }
     return false;
 }
@@ -35,27 +67,12 @@ void free_symbol_table(SymbolTable* table) {
     SymbolEntry* current = table->symbols;
     while (current) {
         SymbolEntry* next = current->next;
-        free(current->name);
         free(current);
         current = next;
     }
+    free(table->index);
     free(table);
 }
-void add_symbol(const char* name) {
-    // Always add to the global symbol_table
-    if (!symbol_table) {
-        symbol_table = create_symbol_table(NULL);
-    }
-    // Check if it already exists
-    SymbolEntry* current = symbol_table->symbols;
-    while (current) {
-        if (strcmp(current->name, name) == 0)
-            return; // Already declared
-        current = current->next;
-    }
-    // Add new variable
-    SymbolEntry* new_entry = malloc(sizeof(SymbolEntry));
-    new_entry->name = strdup(name);
-    new_entry->next = symbol_table->symbols;
-    symbol_table->symbols = new_entry;
+void add_symbol(SymbolTable* table, Atom name) {
+    if (!lookup_symbol(table, name)) insert_symbol(table, name);
 }
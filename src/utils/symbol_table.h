@@ -2,22 +2,30 @@
 #define SYMBOL_TABLE_H
 
 #include <stdbool.h>
+#include "intern.h"
+
+// Names are interned atoms, so entries compare with == instead of strcmp
 typedef struct SymbolEntry {
-    char* name;
+    Atom name;
     struct SymbolEntry* next;
 } SymbolEntry;
 
+// `symbols` keeps the names in insertion order (newest first); `index` is an
+// open-addressing set of the same names, so lookups do not walk the list
 typedef struct SymbolTable {
     struct SymbolTable* parent;
     SymbolEntry* symbols;
+    Atom* index;            // ATOM_NONE marks an empty slot
+    size_t index_capacity;  // power of two, or 0 while the table is empty
+    size_t count;           // distinct names in `index`
 } SymbolTable;
 
-extern SymbolTable* symbol_table;
-void add_symbol(const char* name);
+// Adds `name` unless the table already holds it
+void add_symbol(SymbolTable* table, Atom name);
 
 SymbolTable* create_symbol_table(SymbolTable* parent);
 void free_symbol_table(SymbolTable* table);
-bool insert_symbol(SymbolTable* table, const char* name);
-bool lookup_symbol(SymbolTable* table, const char* name);
+bool insert_symbol(SymbolTable* table, Atom name);
+bool lookup_symbol(SymbolTable* table, Atom name);
 
 #endif
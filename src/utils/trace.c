@@ -0,0 +1,136 @@
+#include "trace.h"
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+static INIT_ONCE trace_once = INIT_ONCE_STATIC_INIT;
+static CRITICAL_SECTION trace_section;
+static BOOL CALLBACK init_trace_lock(PINIT_ONCE once, PVOID param, PVOID* context) {
+    InitializeCriticalSection(&trace_section);
+    return TRUE;
+}
+static void trace_lock(void) {
+    InitOnceExecuteOnce(&trace_once, init_trace_lock, NULL, NULL);
+    EnterCriticalSection(&trace_section);
+}
+static void trace_unlock(void) { LeaveCriticalSection(&trace_section); }
+#else
+#include <pthread.h>
+static pthread_mutex_t trace_mutex = PTHREAD_MUTEX_INITIALIZER;
+static void trace_lock(void) { pthread_mutex_lock(&trace_mutex); }
+static void trace_unlock(void) { pthread_mutex_unlock(&trace_mutex); }
+#endif
+
+#define TRACE_BUFFER_SIZE (64 * 1024)
+#define TRACE_MAX_EVENT 1024
+
+unsigned trace_mask = 0;
+
+static FILE* trace_sink = NULL;
+static char trace_buffer[TRACE_BUFFER_SIZE];
+static size_t trace_used = 0;
+static int trace_registered = 0;
+
+static const struct {
+    const char* name;
+    unsigned category;
+} trace_names[] = {
+    { "lexer", TRACE_LEXER },
+    { "parser", TRACE_PARSER },
+    { "sema", TRACE_SEMA },
+    { "codegen", TRACE_CODEGEN },
+    { "all", TRACE_ALL },
+};
+
+static const char* category_name(unsigned category) {
+    for (size_t i = 0; i < sizeof(trace_names) / sizeof(trace_names[0]); ++i) {
+        if (trace_names[i].category == category) return trace_names[i].name;
+    }
+    return "trace";
+}
+
+static void flush_locked(void) {
+    if (trace_used) {
+        fwrite(trace_buffer, 1, trace_used, trace_sink ? trace_sink : stderr);
+        trace_used = 0;
+    }
+    fflush(trace_sink ? trace_sink : stderr);
+}
+
+void trace_flush(void) {
+    trace_lock();
+    flush_locked();
+    trace_unlock();
+}
+
+void trace_enable(unsigned categories) {
+    trace_mask = categories;
+    if (categories && !trace_registered) {
+        atexit(trace_flush);
+        trace_registered = 1;
+    }
+    if ((categories & TRACE_CATEGORIES) != categories) {
+        fprintf(stderr, "Warning: tracing was not compiled in for some requested categories "
+                        "(rebuild with -DTRACE_CATEGORIES=0x%x)\n", categories);
+    }
+}
+
+int trace_configure(const char* spec) {
+    unsigned categories = 0;
+    int ok = 1;
+    while (spec && *spec) {
+        size_t n = strcspn(spec, ",");
+        size_t i = 0;
+        while (i < sizeof(trace_names) / sizeof(trace_names[0]) &&
+               !(strlen(trace_names[i].name) == n && strncmp(trace_names[i].name, spec, n) == 0)) {
+            ++i;
+        }
+        if (i < sizeof(trace_names) / sizeof(trace_names[0])) {
+            categories |= trace_names[i].category;
+        } else if (n > 0) {
+            fprintf(stderr, "Warning: unknown trace category '%.*s'\n", (int)n, spec);
+            ok = 0;
+        }
+        spec += n;
+        if (*spec == ',') spec++;
+    }
+    trace_enable(categories);
+    return ok;
+}
+
+void trace_set_sink(FILE* sink) {
+    trace_lock();
+    flush_locked();
+    trace_sink = sink;
+    trace_unlock();
+}
+
+void trace_event(unsigned category, const char* event, const char* format, ...) {
+    trace_lock();
+    if (TRACE_BUFFER_SIZE - trace_used < TRACE_MAX_EVENT) flush_locked();
+
+    char* out = trace_buffer + trace_used;
+    size_t room = TRACE_MAX_EVENT - 1;  // keep space for the newline
+    int n = snprintf(out, room, "%s %s ", category_name(category), event);
+    if (n < 0) {
+        trace_unlock();
+        return;
+    }
+    size_t used = (size_t)n < room ? (size_t)n : room - 1;
+
+    va_list args;
+    va_start(args, format);
+    int m = vsnprintf(out + used, room - used, format, args);
+    va_end(args);
+    if (m > 0) {
+        used += (size_t)m < room - used ? (size_t)m : room - used - 1;
+    } else {
+        used--;  // no fields: drop the separator
+    }
+
+    out[used++] = '\n';
+    trace_used += used;
+    trace_unlock();
+}
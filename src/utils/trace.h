@@ -0,0 +1,48 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdio.h>
+
+// Compile-time selectable tracing. Each phase reports events through
+//
+//     TRACE(TRACE_PARSER, "advance", "type=%d text=%.*s", ...);
+//
+// Categories are chosen twice:
+//   - at build time with -DTRACE_CATEGORIES=<mask> (default 0). A category
+//     left out of the mask compiles to nothing, arguments included;
+//   - at run time with trace_enable() / trace_configure(), e.g. from the
+//     MINICC_TRACE environment variable ("parser,sema" or "all").
+//
+// Enabled events are written as one line each, "<category> <event> <fields>",
+// into a buffered sink that is flushed when full, by trace_flush() and at
+// exit. Events may come from any thread; each line is written whole.
+
+#define TRACE_LEXER   0x1u
+#define TRACE_PARSER  0x2u
+#define TRACE_SEMA    0x4u
+#define TRACE_CODEGEN 0x8u
+#define TRACE_ALL     0xFu
+
+#ifndef TRACE_CATEGORIES
+#define TRACE_CATEGORIES 0
+#endif
+
+#if TRACE_CATEGORIES
+extern unsigned trace_mask;  // categories enabled at run time
+
+#define TRACE(category, event, ...)                                          \
+    do {                                                                     \
+        if ((TRACE_CATEGORIES & (category)) && (trace_mask & (category)))    \
+            trace_event((category), (event), __VA_ARGS__);                   \
+    } while (0)
+#else
+#define TRACE(category, event, ...) ((void)0)
+#endif
+
+void trace_enable(unsigned categories);
+int trace_configure(const char* spec);  // comma-separated names; returns 0 on an unknown name
+void trace_set_sink(FILE* sink);        // default stderr
+void trace_event(unsigned category, const char* event, const char* format, ...);
+void trace_flush(void);
+
+#endif // TRACE_H